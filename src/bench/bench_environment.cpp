@@ -0,0 +1,152 @@
+#include "bench_environment.hpp"
+#include "parallel_rrt.hpp"
+#include <algorithm>
+#include <array_math.hpp>
+#include <chrono>
+#include <iterator>
+#include <list>
+
+Bench_environment::Bench_environment(const Scenario &scenario) : Environment(scenario), scenario(scenario) {}
+
+Solve_result Bench_environment::solve(Algorithm algorithm, unsigned seed) {
+    solver.set_seed(seed);
+    collision_checks = 0;
+    exact_checks = 0;
+    clearance_queries = 0;
+
+    std::list<std::array<double, 3>> plan;
+    std::chrono::steady_clock::duration first_solution = std::chrono::steady_clock::duration::max();
+    int iterations = 0;
+    if (algorithm == CSPACE_RRT_STAR) {
+        if (!cspace_grid) { // built once for all of the solves (not included in the solve time)
+            precompute_cspace(std::max(width, height) / CSPACE_CELLS, CSPACE_SLICES);
+            cspace_grid = std::move(cspace);
+        }
+        std::swap(cspace, cspace_grid);
+    }
+    auto start_time = std::chrono::steady_clock::now();
+    switch (algorithm) {
+    case RRT:
+        solver.solve_rrt(plan, scenario.start, scenario.goal, scenario.rrt_iters, scenario.delta);
+        break;
+    case RRT_CONNECT:
+        solver.solve_rrt_connect(plan, scenario.start, scenario.goal, scenario.rrt_iters, scenario.rrts_step,
+                                 scenario.delta);
+        break;
+    case RRT_STAR:
+        solver.solve_k_rrts(plan, scenario.start, scenario.goal, scenario.rrts_iters, scenario.rrts_step,
+                            scenario.delta);
+        break;
+    case LAZY_RRT_STAR:
+        solver.solve_lazy_k_rrts(plan, scenario.start, scenario.goal, scenario.rrts_iters, scenario.rrts_step,
+                                 scenario.delta);
+        break;
+    case PARALLEL_RRT_STAR: {
+        Parallel_RRT_solver<3> parallel({{{0.0, width}, {0.0, height}, {0.0, 2 * M_PI}}}, this, PARALLEL_TREES, seed);
+        parallel.solve_k_rrts(plan, scenario.start, scenario.goal, scenario.rrts_iters, scenario.rrts_step,
+                              scenario.delta);
+        first_solution = parallel.get_first_solution_time();
+        iterations = parallel.get_iterations();
+        break;
+    }
+    case INFORMED_RRT_STAR:
+        solver.set_informed_sampling(true, true);
+        solver.solve_k_rrts(plan, scenario.start, scenario.goal, scenario.rrts_iters, scenario.rrts_step,
+                            scenario.delta);
+        solver.set_informed_sampling(false, false);
+        break;
+    case ANYTIME_RRT_STAR:
+        solver.start_anytime(scenario.start, scenario.goal, scenario.rrts_step, scenario.delta);
+        while (solver.get_iterations() < scenario.rrts_iters) {
+            solver.solve_anytime(plan, ANYTIME_CYCLE);
+        }
+        break;
+    case CSPACE_RRT_STAR:
+        solver.solve_k_rrts(plan, scenario.start, scenario.goal, scenario.rrts_iters, scenario.rrts_step,
+                            scenario.delta);
+        break;
+    case BISECTION_RRT_STAR:
+    case ADVANCEMENT_RRT_STAR:
+        solver.set_segment_validation(algorithm == BISECTION_RRT_STAR ? RRT_solver<3>::BISECTION
+                                                                      : RRT_solver<3>::CONSERVATIVE_ADVANCEMENT);
+        solver.solve_k_rrts(plan, scenario.start, scenario.goal, scenario.rrts_iters, scenario.rrts_step,
+                            scenario.delta);
+        solver.set_segment_validation(RRT_solver<3>::FIXED_STEP);
+        break;
+    }
+    std::chrono::duration<double> solve_time = std::chrono::steady_clock::now() - start_time;
+    if (algorithm == CSPACE_RRT_STAR) {
+        std::swap(cspace, cspace_grid); // other algorithms use the exact checks
+    }
+    if (algorithm != PARALLEL_RRT_STAR) {
+        first_solution = solver.get_first_solution_time();
+        iterations = solver.get_iterations();
+    }
+
+    Solve_result result;
+    result.solved = !plan.empty();
+    result.solve_time = solve_time.count();
+    result.first_solution_time = std::chrono::duration<double>(first_solution).count();
+    result.cost = 0.0;
+    for (auto it = plan.begin(); it != plan.end() && std::next(it) != plan.end(); it++) {
+        result.cost += vector_distance(*it, *std::next(it));
+    }
+    result.iterations = iterations;
+    result.collision_checks = collision_checks;
+    result.exact_checks = exact_checks;
+    result.clearance_queries = clearance_queries;
+    return result;
+}
+
+const char *Bench_environment::get_name(Algorithm algorithm) {
+    switch (algorithm) {
+    case RRT:
+        return "rrt";
+    case RRT_CONNECT:
+        return "rrt-connect";
+    case RRT_STAR:
+        return "rrt*";
+    case LAZY_RRT_STAR:
+        return "lazy-rrt*";
+    case PARALLEL_RRT_STAR:
+        return "parallel-rrt*";
+    case INFORMED_RRT_STAR:
+        return "informed-rrt*";
+    case ANYTIME_RRT_STAR:
+        return "anytime-rrt*";
+    case CSPACE_RRT_STAR:
+        return "cspace-rrt*";
+    case BISECTION_RRT_STAR:
+        return "bisection-rrt*";
+    default:
+        return "advancement-rrt*";
+    }
+}
+
+bool Bench_environment::check_collision(const double state[], Collision_context &context) const {
+    collision_checks.fetch_add(1, std::memory_order_relaxed);
+    if (needs_exact_check(state)) {
+        exact_checks.fetch_add(1, std::memory_order_relaxed);
+    }
+    return Environment::check_collision(state, context);
+}
+
+void Bench_environment::check_collisions(const double states[], size_t count, size_t stride, bool results[],
+                                         Collision_context &context) const {
+    collision_checks.fetch_add(count, std::memory_order_relaxed);
+    size_t exact = count;
+    if (cspace) {
+        exact = 0;
+        for (size_t i = 0; i < count; i++) {
+            exact += needs_exact_check(states + i * stride);
+        }
+    }
+    exact_checks.fetch_add(exact, std::memory_order_relaxed);
+    Environment::check_collisions(states, count, stride, results, context);
+}
+
+double Bench_environment::get_clearance(const double state[], Collision_context &context, double range,
+                                        double threshold, int &closest) const {
+    clearance_queries.fetch_add(1, std::memory_order_relaxed);
+    return Environment::get_clearance(state, context, range, threshold, closest);
+}
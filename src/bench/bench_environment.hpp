@@ -0,0 +1,80 @@
+#pragma once
+
+#include "environment.hpp"
+#include "scenario.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/** Measurements of one solve. */
+struct Solve_result {
+    bool solved;
+    double solve_time;          // wall time of the solve in seconds
+    double first_solution_time; // time from the start of the solve to the first path in seconds (if solved)
+    double cost;                // length of the result plan (if solved)
+    int iterations;
+    size_t collision_checks;  // number of states passed to the collision detector
+    size_t exact_checks;      // number of them checked by the narrow phase (not answered by the cspace grid)
+    size_t clearance_queries; // number of the distance queries (get_clearance, used by get_free_radius too)
+};
+
+/**
+ * Environment of a scenario running the solves headless (nothing is rendered) and counting the collision checks and
+ * the clearance queries.
+ */
+class Bench_environment : public Environment {
+  public:
+    enum Algorithm {
+        RRT,
+        RRT_CONNECT,
+        RRT_STAR,
+        LAZY_RRT_STAR,
+        PARALLEL_RRT_STAR,
+        INFORMED_RRT_STAR,
+        ANYTIME_RRT_STAR,
+        CSPACE_RRT_STAR,
+        BISECTION_RRT_STAR,
+        ADVANCEMENT_RRT_STAR
+    };
+    static constexpr Algorithm ALGORITHMS[] = {RRT, RRT_CONNECT, RRT_STAR, LAZY_RRT_STAR, PARALLEL_RRT_STAR,
+                                               INFORMED_RRT_STAR, ANYTIME_RRT_STAR, CSPACE_RRT_STAR,
+                                               BISECTION_RRT_STAR, ADVANCEMENT_RRT_STAR};
+    static constexpr size_t PARALLEL_TREES = 4; // trees (and threads) of PARALLEL_RRT_STAR
+    // ANYTIME_RRT_STAR plans in cycles of this budget until it makes the iterations of RRT_STAR:
+    static constexpr std::chrono::milliseconds ANYTIME_CYCLE{10};
+    // grid of CSPACE_RRT_STAR - cells along the longer side of the world and rotation slices:
+    static constexpr int CSPACE_CELLS = 100;
+    static constexpr int CSPACE_SLICES = 32;
+
+  private:
+    Scenario scenario;
+    mutable std::atomic<size_t> collision_checks{0};
+    mutable std::atomic<size_t> exact_checks{0};
+    mutable std::atomic<size_t> clearance_queries{0};
+    std::unique_ptr<Cspace_grid> cspace_grid; // grid of CSPACE_RRT_STAR (used only by it's solves)
+
+  public:
+    explicit Bench_environment(const Scenario &scenario);
+
+    /** Solves the scenario by the algorithm with the solver seeded by the seed. */
+    Solve_result solve(Algorithm algorithm, unsigned seed);
+
+    static const char *get_name(Algorithm algorithm);
+
+    // counting overrides of the Collision_detector interface:
+    using Environment::check_collision;
+    bool check_collision(const double state[], Collision_context &context) const override;
+    using Environment::check_collisions;
+    void check_collisions(const double states[], size_t count, size_t stride, bool results[],
+                          Collision_context &context) const override;
+    using Environment::get_clearance;
+    double get_clearance(const double state[], Collision_context &context, double range, double threshold,
+                         int &closest) const override;
+
+  private:
+    /** Returns true if the state is not answered by the cspace grid (the grid lookup is repeated by the Environment
+     * check, it's cost is negligible compared to the narrow phase). */
+    bool needs_exact_check(const double state[]) const {
+        return !cspace || cspace->lookup(state) == Cspace_grid::UNKNOWN;
+    }
+};
@@ -0,0 +1,169 @@
+#include "bench_environment.hpp"
+#include "scenario.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef PATHFINDER_BUILD_TYPE
+#define PATHFINDER_BUILD_TYPE "unknown"
+#endif
+
+/**
+ * Headless benchmark of the solvers. Every scenario (the test scenarios and larger generated maps) is solved by every
+ * algorithm with multiple seeds and the statistics of the solves are printed as JSON:
+ *
+ *   pathfinder_bench [--seeds N] [--first-seed S] [--scenario NAME]... [--output FILE] [--trace FILE]
+ *
+ * --trace records the timeline of the solves as Chrome trace event JSON (only the latest events of every thread are
+ * kept, see Trace).
+ */
+
+namespace {
+
+/** Returns the percentile (0 - 1) of the sorted samples (nearest rank method). */
+double percentile(const std::vector<double> &sorted, double fraction) {
+    size_t rank = (size_t)std::ceil(fraction * sorted.size());
+    return sorted[std::clamp(rank, (size_t)1, sorted.size()) - 1];
+}
+
+/** Writes the median, p95 and p99 of the samples as a JSON object (null if there are no samples). */
+void write_summary(std::ostream &out, const char *name, std::vector<double> samples) {
+    out << "      \"" << name << "\": ";
+    if (samples.empty()) {
+        out << "null";
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    out << "{\"median\": " << percentile(samples, 0.5) << ", \"p95\": " << percentile(samples, 0.95)
+        << ", \"p99\": " << percentile(samples, 0.99) << ", \"min\": " << samples.front()
+        << ", \"max\": " << samples.back() << "}";
+}
+
+/** Writes the statistics of the solves of one scenario by one algorithm as a JSON object. */
+void write_results(std::ostream &out, const std::string &scenario, const char *algorithm,
+                   const std::vector<Solve_result> &results) {
+    std::vector<double> first_solution_times, solve_times, costs, iteration_rates, collision_checks, exact_checks,
+        clearance_queries;
+    for (const Solve_result &result : results) {
+        if (result.solved) {
+            first_solution_times.push_back(result.first_solution_time * 1000);
+            costs.push_back(result.cost);
+        }
+        solve_times.push_back(result.solve_time * 1000);
+        iteration_rates.push_back(result.iterations / result.solve_time);
+        collision_checks.push_back(result.collision_checks);
+        exact_checks.push_back(result.exact_checks);
+        clearance_queries.push_back(result.clearance_queries);
+    }
+
+    out << "    {\n";
+    out << "      \"scenario\": \"" << scenario << "\",\n";
+    out << "      \"algorithm\": \"" << algorithm << "\",\n";
+    out << "      \"runs\": " << results.size() << ",\n";
+    out << "      \"solved\": " << first_solution_times.size() << ",\n";
+    write_summary(out, "time_to_first_solution_ms", first_solution_times);
+    out << ",\n";
+    write_summary(out, "solve_time_ms", solve_times);
+    out << ",\n";
+    write_summary(out, "path_cost", costs);
+    out << ",\n";
+    write_summary(out, "iterations_per_second", iteration_rates);
+    out << ",\n";
+    write_summary(out, "collision_checks", collision_checks);
+    out << ",\n";
+    write_summary(out, "exact_checks", exact_checks);
+    out << ",\n";
+    write_summary(out, "clearance_queries", clearance_queries);
+    out << "\n    }";
+}
+
+void print_usage() {
+    std::cerr << "usage: pathfinder_bench [--seeds N] [--first-seed S] [--scenario NAME]... [--output FILE] "
+                 "[--trace FILE]"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int seeds = 10;
+    unsigned first_seed = 1;
+    std::vector<std::string> selected; // names of the scenarios to run (all if empty)
+    std::string output_file, trace_file;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && std::strcmp(argv[i], "--seeds") == 0) {
+            seeds = std::max(1, std::atoi(argv[++i]));
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--first-seed") == 0) {
+            first_seed = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--scenario") == 0) {
+            selected.push_back(argv[++i]);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--output") == 0) {
+            output_file = argv[++i];
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--trace") == 0) {
+            trace_file = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    std::vector<Scenario> scenarios = test_scenarios();
+    scenarios.push_back(generated_scenario("forest_200x100", 200.0, 100.0, 60, 1));
+    scenarios.push_back(generated_scenario("forest_400x200", 400.0, 200.0, 160, 2));
+    if (!selected.empty()) {
+        std::erase_if(scenarios, [&](const Scenario &scenario) {
+            return std::find(selected.begin(), selected.end(), scenario.name) == selected.end();
+        });
+    }
+
+    std::ofstream file;
+    if (!output_file.empty()) {
+        file.open(output_file);
+        if (!file) {
+            std::cerr << "can't open " << output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &out = output_file.empty() ? std::cout : file;
+    if (!trace_file.empty()) {
+        Trace::start();
+    }
+
+    out << "{\n";
+    out << "  \"build_type\": \"" << PATHFINDER_BUILD_TYPE << "\",\n";
+    out << "  \"seeds\": " << seeds << ",\n";
+    out << "  \"first_seed\": " << first_seed << ",\n";
+    out << "  \"results\": [\n";
+    bool first = true;
+    for (const Scenario &scenario : scenarios) {
+        Bench_environment env(scenario);
+        for (Bench_environment::Algorithm algorithm : Bench_environment::ALGORITHMS) {
+            std::vector<Solve_result> results;
+            int solved = 0;
+            for (int i = 0; i < seeds; i++) {
+                results.push_back(env.solve(algorithm, first_seed + i));
+                solved += results.back().solved;
+            }
+            std::cerr << scenario.name << " " << Bench_environment::get_name(algorithm) << ": " << solved << "/"
+                      << seeds << " solved" << std::endl;
+
+            out << (first ? "" : ",\n");
+            write_results(out, scenario.name, Bench_environment::get_name(algorithm), results);
+            first = false;
+        }
+    }
+    out << "\n  ]\n}" << std::endl;
+
+    if (!trace_file.empty()) {
+        Trace::stop();
+        if (!Trace::write_json(trace_file)) {
+            std::cerr << "can't write " << trace_file << std::endl;
+            return 1;
+        }
+    }
+}
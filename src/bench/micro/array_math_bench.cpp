@@ -0,0 +1,47 @@
+#include "benchmarks.hpp"
+#include <array_math.hpp>
+#include <random>
+
+namespace {
+
+constexpr size_t VECTORS = 1024; // operands are cycled through (power of two, so the index is masked cheaply)
+
+/** Measures the operation on the pairs of consecutive vectors. */
+template <size_t N, typename Operation>
+void run(Micro_bench &bench, const std::string &name, const std::vector<std::array<double, N>> &vectors,
+         Operation operation) {
+    size_t i = 0;
+    bench.run(name, N, 1, [&]() {
+        i = (i + 1) & (VECTORS - 1);
+        do_not_optimize(operation(vectors[i], vectors[i + 1]));
+    });
+}
+
+template <size_t N> void benchmark_dimension(Micro_bench &bench) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dis(-100.0, 100.0);
+    std::vector<std::array<double, N>> vectors(VECTORS + 1); // the last operand of the last pair is extra
+    for (auto &vector : vectors) {
+        for (double &coord : vector) {
+            coord = dis(gen);
+        }
+    }
+
+    typedef const std::array<double, N> &Vector;
+    run(bench, "vector_add", vectors, [](Vector a, Vector b) { return vector_add(a, b); });
+    run(bench, "vector_diff", vectors, [](Vector a, Vector b) { return vector_diff(a, b); });
+    run(bench, "vector_mult", vectors, [](Vector a, Vector) { return vector_mult(0.5, a); });
+    run(bench, "vector_add_scaled", vectors, [](Vector a, Vector b) { return vector_add_scaled(a, 0.5, b); });
+    run(bench, "vector_dot", vectors, [](Vector a, Vector b) { return vector_dot(a, b); });
+    run(bench, "vector_norm", vectors, [](Vector a, Vector) { return vector_norm(a); });
+    run(bench, "vector_distance", vectors, [](Vector a, Vector b) { return vector_distance(a, b); });
+    run(bench, "vector_distance_sq", vectors, [](Vector a, Vector b) { return vector_distance_sq(a, b); });
+}
+
+} // namespace
+
+void array_math_benchmarks(Micro_bench &bench) {
+    benchmark_dimension<2>(bench);
+    benchmark_dimension<3>(bench);
+    benchmark_dimension<7>(bench);
+}
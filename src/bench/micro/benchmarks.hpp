@@ -0,0 +1,12 @@
+#pragma once
+
+#include "micro_bench.hpp"
+
+/** Benchmarks of the vector operations of array_math.hpp (for the dimensions used by the solvers). */
+void array_math_benchmarks(Micro_bench &bench);
+
+/** Benchmarks of the vertex insertion and nearest neighbour queries of Graph with growing tree size. */
+void graph_benchmarks(Micro_bench &bench);
+
+/** Benchmarks of Model_2D::move and the collision checks with growing triangle counts of the models. */
+void model_benchmarks(Micro_bench &bench);
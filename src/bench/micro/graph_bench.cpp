@@ -0,0 +1,58 @@
+#include "benchmarks.hpp"
+#include <cmath>
+#include <graph.hpp>
+#include <random>
+
+namespace {
+
+constexpr size_t SIZES[] = {1000, 10000, 100000}; // tree sizes of the sweep
+constexpr size_t QUERIES = 1024;                   // random query states cycled through (power of two)
+
+/** Returns random states of the (x, y, angle) configuration space of the test scenarios. */
+std::vector<std::array<double, 3>> random_states(size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> x_dis(0.0, 100.0), y_dis(0.0, 50.0), angle_dis(0.0, 2 * M_PI);
+    std::vector<std::array<double, 3>> states(count);
+    for (auto &state : states) {
+        state = {x_dis(gen), y_dis(gen), angle_dis(gen)};
+    }
+    return states;
+}
+
+} // namespace
+
+void graph_benchmarks(Micro_bench &bench) {
+    std::vector<std::array<double, 3>> queries = random_states(QUERIES, 2);
+    for (size_t size : SIZES) {
+        std::vector<std::array<double, 3>> states = random_states(size, 1);
+        Graph<3> graph;
+
+        // the whole tree is built by one call (clearing of the graph is included):
+        bench.run("graph_add_vertex", size, size, [&]() {
+            graph.clear();
+            for (const auto &state : states) {
+                do_not_optimize(graph.add_vertex(state).id());
+            }
+        });
+
+        // queries on the tree of the full size:
+        graph.clear();
+        for (const auto &state : states) {
+            graph.add_vertex(state);
+        }
+        size_t i = 0;
+        bench.run("graph_get_nearest", size, 1, [&]() {
+            i = (i + 1) & (QUERIES - 1);
+            do_not_optimize(graph.get_nearest(queries[i]).id());
+        });
+
+        std::vector<Graph<3>::Vertex> k_nearest;
+        size_t k = (size_t)(2 * M_E * std::log(size)); // number of neighbours used by the RRT* solvers
+        bench.run("graph_get_k_nearest", size, 1, [&]() {
+            i = (i + 1) & (QUERIES - 1);
+            k_nearest.clear(); // get_k_nearest appends to the vector
+            graph.get_k_nearest(k_nearest, queries[i], k);
+            do_not_optimize(k_nearest.data());
+        });
+    }
+}
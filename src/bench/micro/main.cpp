@@ -0,0 +1,49 @@
+#include "benchmarks.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * Micro-benchmarks of the hot primitives of the solvers (see micro_bench.hpp for the methodology):
+ *
+ *   pathfinder_microbench [--filter SUBSTRING] [--repetitions N] [--min-time SECONDS] [--output FILE]
+ *
+ * Results are printed as a table, --output writes them also as JSON.
+ */
+int main(int argc, char *argv[]) {
+    Micro_bench::Options options;
+    std::string output_file;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && std::strcmp(argv[i], "--filter") == 0) {
+            options.filter = argv[++i];
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--repetitions") == 0) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--min-time") == 0) {
+            options.min_time = std::atof(argv[++i]);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--output") == 0) {
+            output_file = argv[++i];
+        } else {
+            std::cerr << "usage: pathfinder_microbench [--filter SUBSTRING] [--repetitions N] [--min-time SECONDS] "
+                         "[--output FILE]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    Micro_bench bench(options);
+    Micro_bench::print_header();
+    array_math_benchmarks(bench);
+    graph_benchmarks(bench);
+    model_benchmarks(bench);
+
+    if (!output_file.empty()) {
+        std::ofstream file(output_file);
+        if (!file) {
+            std::cerr << "can't open " << output_file << std::endl;
+            return 1;
+        }
+        bench.write_json(file);
+    }
+}
@@ -0,0 +1,67 @@
+#include "micro_bench.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+void *allocate(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+// replacements of the global allocation functions counting the allocations of the whole program:
+void *operator new(size_t size) { return allocate(size); }
+void *operator new[](size_t size) { return allocate(size); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+
+size_t allocation_count() { return allocations.load(std::memory_order_relaxed); }
+
+Micro_bench::Micro_bench(const Options &options) : options(options) {}
+
+void Micro_bench::add_result(const std::string &name, size_t n, std::vector<double> &times, size_t ops,
+                             size_t allocations) {
+    std::sort(times.begin(), times.end());
+    Result result;
+    result.name = name;
+    result.n = n;
+    result.ns_per_op = times[times.size() / 2] * 1e9 / ops;
+    result.min_ns_per_op = times.front() * 1e9 / ops;
+    result.max_ns_per_op = times.back() * 1e9 / ops;
+    result.allocations_per_op = (double)allocations / (ops * times.size());
+    results.push_back(result);
+
+    std::printf("%-40s %8zu %12.2f ns/op  [%.2f - %.2f]  %8.3f allocs/op\n", name.c_str(), n, result.ns_per_op,
+                result.min_ns_per_op, result.max_ns_per_op, result.allocations_per_op);
+    std::fflush(stdout);
+}
+
+void Micro_bench::print_header() {
+    std::printf("%-40s %8s %18s  %s\n", "benchmark", "n", "time", "[min - max]  allocations");
+}
+
+void Micro_bench::write_json(std::ostream &out) const {
+    out << "{\n  \"repetitions\": " << options.repetitions << ",\n  \"min_time\": " << options.min_time
+        << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", \"n\": " << result.n
+            << ", \"ns_per_op\": " << result.ns_per_op << ", \"min_ns_per_op\": " << result.min_ns_per_op
+            << ", \"max_ns_per_op\": " << result.max_ns_per_op
+            << ", \"allocations_per_op\": " << result.allocations_per_op << "}" << (i + 1 < results.size() ? "," : "")
+            << "\n";
+    }
+    out << "  ]\n}" << std::endl;
+}
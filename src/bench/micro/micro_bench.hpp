@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal micro-benchmark harness. Every benchmark is calibrated first (the number of operations per repetition is
+ * doubled until a repetition takes at least the minimal time), then runs one discarded warm-up repetition and the
+ * measured repetitions. Reported are the median, minimum and maximum time per operation over the repetitions and the
+ * number of heap allocations per operation (counted by the replaced global operator new of the micro-benchmark
+ * executable).
+ */
+
+/** Returns the number of heap allocations made by the program so far. */
+size_t allocation_count();
+
+/** Prevents the compiler from optimizing out the computation of the value. */
+template <typename T> inline void do_not_optimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+class Micro_bench {
+  public:
+    struct Options {
+        double min_time = 0.02; // minimal duration of one repetition in seconds
+        int repetitions = 7;    // number of measured repetitions
+        std::string filter;     // only benchmarks whose name contains the filter are run
+    };
+
+    struct Result {
+        std::string name;
+        size_t n;                  // size parameter of the benchmark (tree size, triangle count, ...)
+        double ns_per_op;          // median over the repetitions
+        double min_ns_per_op;      // fastest repetition
+        double max_ns_per_op;      // slowest repetition
+        double allocations_per_op; // average over the measured repetitions
+    };
+
+  private:
+    Options options;
+    std::vector<Result> results;
+
+  public:
+    explicit Micro_bench(const Options &options);
+
+    /**
+     * Measures the operation. The operation is called repeatedly, every call performs ops_per_call operations of the
+     * measured primitive (e.g. a call which builds a tree of n vertices performs n insertions).
+     *
+     * @param name name of the benchmark
+     * @param n size parameter of the benchmark (reported with the results)
+     * @param ops_per_call number of operations performed by one call of the operation
+     * @param operation function without parameters
+     */
+    template <typename Operation>
+    void run(const std::string &name, size_t n, size_t ops_per_call, Operation &&operation);
+
+    const std::vector<Result> &get_results() const { return results; }
+
+    /** Prints the header of the table of the results (every result is printed as soon as it's measured). */
+    static void print_header();
+    /** Writes the results as JSON. */
+    void write_json(std::ostream &out) const;
+
+  private:
+    /** Stores the result computed from the repetition times (in seconds) and allocations. */
+    void add_result(const std::string &name, size_t n, std::vector<double> &times, size_t ops, size_t allocations);
+};
+
+template <typename Operation>
+void Micro_bench::run(const std::string &name, size_t n, size_t ops_per_call, Operation &&operation) {
+    if (name.find(options.filter) == std::string::npos) {
+        return;
+    }
+
+    auto repetition = [&](size_t calls) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; i++) {
+            operation();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // calibration (serves also as the first warm-up):
+    size_t calls = 1;
+    double time;
+    while ((time = repetition(calls)) < options.min_time) {
+        calls *= time > 0.0 ? std::clamp<size_t>((size_t)(options.min_time / time), 2, 100) : 100;
+    }
+    repetition(calls); // warm-up at the final size
+
+    std::vector<double> times;
+    size_t allocations = allocation_count();
+    for (int i = 0; i < options.repetitions; i++) {
+        times.push_back(repetition(calls));
+    }
+    allocations = allocation_count() - allocations;
+    add_result(name, n, times, calls * ops_per_call, allocations);
+}
@@ -0,0 +1,67 @@
+#include "benchmarks.hpp"
+#include <cmath>
+#include <model_2D.hpp>
+#include <random>
+
+namespace {
+
+constexpr int TRIANGLE_COUNTS[] = {2, 8, 32, 128}; // triangle counts of both models of the sweep
+constexpr size_t POSES = 1024;                     // random poses of the robot cycled through (power of two)
+constexpr double MODEL_RADIUS = 5.0;
+
+/** Returns the star shaped (non convex) model made of the fan of count triangles around the origin. */
+std::vector<Triangle_2D> star_model(int count) {
+    std::vector<Triangle_2D> triangles;
+    auto vertex = [&](int i) {
+        double radius = i % 2 ? MODEL_RADIUS / 2 : MODEL_RADIUS;
+        double angle = 2 * M_PI * i / count;
+        return Point_2D(radius * std::cos(angle), radius * std::sin(angle));
+    };
+    for (int i = 0; i < count; i++) {
+        triangles.push_back({Point_2D(0.0, 0.0), vertex(i), vertex(i + 1)});
+    }
+    return triangles;
+}
+
+} // namespace
+
+void model_benchmarks(Micro_bench &bench) {
+    // robot poses around the obstacle in the origin (about a half of them collides):
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> position_dis(-2.5 * MODEL_RADIUS, 2.5 * MODEL_RADIUS);
+    std::uniform_real_distribution<double> angle_dis(0.0, 2 * M_PI);
+    std::vector<double> poses;
+    for (size_t i = 0; i < POSES; i++) {
+        poses.insert(poses.end(), {position_dis(gen), position_dis(gen), angle_dis(gen)});
+    }
+
+    for (int count : TRIANGLE_COUNTS) {
+        Model_2D robot(star_model(count), Color(0, 0, 0));
+        Model_2D obstacle(star_model(count), Color(0, 0, 0));
+        size_t i = 0;
+        auto next_pose = [&]() {
+            i = (i + 1) & (POSES - 1);
+            return &poses[3 * i];
+        };
+
+        bench.run("model_move", count, 1, [&]() {
+            const double *pose = next_pose();
+            robot.move(pose[0], pose[1], pose[2]);
+            do_not_optimize(robot);
+        });
+        bench.run("model_move_collides_with", count, 1, [&]() {
+            const double *pose = next_pose();
+            robot.move(pose[0], pose[1], pose[2]);
+            do_not_optimize(robot.collides_with(obstacle));
+        });
+        bench.run("model_collides_with_pose", count, 1, [&]() {
+            const double *pose = next_pose();
+            do_not_optimize(robot.collides_with(pose[0], pose[1], pose[2], obstacle));
+        });
+        // one call checks BATCH_SIZE consecutive poses:
+        bench.run("model_collides_with_batch", count, Model_2D::BATCH_SIZE, [&]() {
+            i = (i + Model_2D::BATCH_SIZE) & (POSES - 1);
+            do_not_optimize(robot.collides_with_batch(&poses[3 * i], Model_2D::BATCH_SIZE, obstacle));
+        });
+    }
+}
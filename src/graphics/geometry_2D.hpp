@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "graphic_primitives.hpp"
+
+/**
+ * Distance queries between the 2D primitives (points, segments and triangles).
+ */
+
+/**
+ * Returns the z coordinate of the cross product of vectors origin->a and origin->b (positive if a, b are counter
+ * clockwise around the origin).
+ */
+inline double cross(const Point_2D &origin, const Point_2D &a, const Point_2D &b) {
+    return (a.get_x() - origin.get_x()) * (b.get_y() - origin.get_y()) -
+           (a.get_y() - origin.get_y()) * (b.get_x() - origin.get_x());
+}
+
+/**
+ * Returns the squared distance of the point from the segment [a, b].
+ */
+inline double point_segment_distance_sq(const Point_2D &point, const Point_2D &a, const Point_2D &b) {
+    double dx = b.get_x() - a.get_x();
+    double dy = b.get_y() - a.get_y();
+    double length_sq = dx * dx + dy * dy;
+    double t = 0.0;
+    if (length_sq > 0.0) {
+        t = std::clamp(((point.get_x() - a.get_x()) * dx + (point.get_y() - a.get_y()) * dy) / length_sq, 0.0, 1.0);
+    }
+    double px = point.get_x() - (a.get_x() + t * dx);
+    double py = point.get_y() - (a.get_y() + t * dy);
+    return px * px + py * py;
+}
+
+/**
+ * Returns true if the point lies inside of the triangle (or on it's boundary).
+ */
+inline bool point_in_triangle(const Point_2D &point, const Triangle_2D &triangle) {
+    double first = cross(triangle.vertices[0], triangle.vertices[1], point);
+    double second = cross(triangle.vertices[1], triangle.vertices[2], point);
+    double third = cross(triangle.vertices[2], triangle.vertices[0], point);
+    return (first >= 0.0 && second >= 0.0 && third >= 0.0) || (first <= 0.0 && second <= 0.0 && third <= 0.0);
+}
+
+/**
+ * Returns the distance between two triangles (zero if they intersect).
+ */
+inline double triangle_distance(const Triangle_2D &first, const Triangle_2D &second) {
+    for (int i = 0; i < 3; i++) {
+        if (point_in_triangle(first.vertices[i], second) || point_in_triangle(second.vertices[i], first)) {
+            return 0.0;
+        }
+    }
+
+    double distance_sq = INFINITY;
+    for (int i = 0; i < 3; i++) {
+        const Point_2D &a = first.vertices[i];
+        const Point_2D &b = first.vertices[(i + 1) % 3];
+        for (int j = 0; j < 3; j++) {
+            const Point_2D &c = second.vertices[j];
+            const Point_2D &d = second.vertices[(j + 1) % 3];
+            if (cross(a, b, c) * cross(a, b, d) < 0.0 && cross(c, d, a) * cross(c, d, b) < 0.0) {
+                return 0.0; // edges cross each other
+            }
+            // distance of non-crossing segments is attained at one of their endpoints:
+            distance_sq = std::min(
+                {distance_sq, point_segment_distance_sq(a, c, d), point_segment_distance_sq(c, a, b)});
+        }
+    }
+    return std::sqrt(distance_sq);
+}
+
+/**
+ * Returns the distance of the point from the boundary of the triangle if it lies inside of it, zero otherwise.
+ */
+inline double penetration_depth(const Point_2D &point, const Triangle_2D &triangle) {
+    if (!point_in_triangle(point, triangle)) {
+        return 0.0;
+    }
+    double depth = INFINITY;
+    for (int i = 0; i < 3; i++) {
+        const Point_2D &a = triangle.vertices[i];
+        const Point_2D &b = triangle.vertices[(i + 1) % 3];
+        double length = std::hypot(b.get_x() - a.get_x(), b.get_y() - a.get_y());
+        if (length == 0.0) {
+            return 0.0; // degenerated triangle
+        }
+        depth = std::min(depth, std::abs(cross(a, b, point)) / length);
+    }
+    return depth;
+}
+
+/**
+ * Returns the distance between two axis aligned boxes (zero if they overlap).
+ */
+inline double box_distance(const Box_2D &first, const Box_2D &second) {
+    double dx = std::max({0.0, first.min.get_x() - second.max.get_x(), second.min.get_x() - first.max.get_x()});
+    double dy = std::max({0.0, first.min.get_y() - second.max.get_y(), second.min.get_y() - first.max.get_y()});
+    return std::sqrt(dx * dx + dy * dy);
+}
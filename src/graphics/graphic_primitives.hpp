@@ -28,3 +28,14 @@ struct Color {
 struct Triangle_2D {
     Point_2D vertices[3];
 };
+
+/** Axis aligned bounding box */
+struct Box_2D {
+    Point_2D min;
+    Point_2D max;
+
+    bool overlaps(const Box_2D &other) const {
+        return min.get_x() <= other.max.get_x() && other.min.get_x() <= max.get_x() &&
+               min.get_y() <= other.max.get_y() && other.min.get_y() <= max.get_y();
+    }
+};
@@ -1,7 +1,82 @@
 #include "model_2D.hpp"
 
+#include <algorithm>
 #include <cmath>
 
+#include "geometry_2D.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#if defined(__AVX__)
+/** Values of the Model_2D::BATCH_SIZE lanes of the batched separating axis test (one AVX register). */
+struct Lanes {
+    __m256d v;
+
+    static Lanes set(double value) { return {_mm256_set1_pd(value)}; }
+    static Lanes load(const double values[]) { return {_mm256_loadu_pd(values)}; }
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline Lanes operator-(Lanes a, Lanes b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline Lanes operator*(Lanes a, Lanes b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline Lanes min(Lanes a, Lanes b) { return {_mm256_min_pd(a.v, b.v)}; }
+inline Lanes max(Lanes a, Lanes b) { return {_mm256_max_pd(a.v, b.v)}; }
+/** Returns the bit mask of the lanes in which a < b. */
+inline int less(Lanes a, Lanes b) { return _mm256_movemask_pd(_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)); }
+#else
+/** Values of the Model_2D::BATCH_SIZE lanes of the batched separating axis test (plain loops, the compiler can
+ * vectorize them for the available instruction set). */
+struct Lanes {
+    double v[Model_2D::BATCH_SIZE];
+
+    static Lanes set(double value) {
+        Lanes lanes;
+        std::fill(lanes.v, lanes.v + Model_2D::BATCH_SIZE, value);
+        return lanes;
+    }
+    static Lanes load(const double values[]) {
+        Lanes lanes;
+        std::copy(values, values + Model_2D::BATCH_SIZE, lanes.v);
+        return lanes;
+    }
+};
+
+template <typename Operation> inline Lanes apply(Lanes a, Lanes b, Operation operation) {
+    Lanes result;
+    for (int i = 0; i < Model_2D::BATCH_SIZE; i++) {
+        result.v[i] = operation(a.v[i], b.v[i]);
+    }
+    return result;
+}
+
+inline Lanes operator+(Lanes a, Lanes b) { return apply(a, b, [](double x, double y) { return x + y; }); }
+inline Lanes operator-(Lanes a, Lanes b) { return apply(a, b, [](double x, double y) { return x - y; }); }
+inline Lanes operator*(Lanes a, Lanes b) { return apply(a, b, [](double x, double y) { return x * y; }); }
+inline Lanes min(Lanes a, Lanes b) { return apply(a, b, [](double x, double y) { return std::min(x, y); }); }
+inline Lanes max(Lanes a, Lanes b) { return apply(a, b, [](double x, double y) { return std::max(x, y); }); }
+/** Returns the bit mask of the lanes in which a < b. */
+inline int less(Lanes a, Lanes b) {
+    int mask = 0;
+    for (int i = 0; i < Model_2D::BATCH_SIZE; i++) {
+        mask |= (a.v[i] < b.v[i]) << i;
+    }
+    return mask;
+}
+#endif
+
+/** Returns the bit mask of the lanes in which the projections [a_min, a_max] and [b_min, b_max] don't overlap. */
+inline int separated(Lanes a_min, Lanes a_max, Lanes b_min, Lanes b_max) {
+    return less(a_max, b_min) | less(b_max, a_min);
+}
+
+} // namespace
+
+thread_local Model_2D::Collision_stats Model_2D::collision_stats;
+
 Model_2D::Model_2D(const std::vector<Triangle_2D> &triangles, const Color &color) : triangles(triangles), color(color) {
     // initializing RAPID model for collision detection
     rapid_model = std::make_unique<RAPID_model>();
@@ -17,52 +92,268 @@ Model_2D::Model_2D(const std::vector<Triangle_2D> &triangles, const Color &color
     }
     rapid_model->EndModel();
 
+    radius = 0.0;
+    for (const Triangle_2D &triangle : triangles) {
+        for (const Point_2D &point : triangle.vertices) {
+            radius = std::max(radius, std::hypot(point.get_x(), point.get_y()));
+        }
+    }
+
     move(0.0, 0.0, 0.0);
 }
 
 void Model_2D::move(double x, double y, double angle) {
-    // computing the rotation matrix:
-    rot_matrix[0][0] = cos(angle);
-    rot_matrix[0][1] = -1.0 * sin(angle);
-    rot_matrix[0][2] = 0.0;
-    rot_matrix[1][0] = sin(angle);
-    rot_matrix[1][1] = cos(angle);
-    rot_matrix[1][2] = 0.0;
-    rot_matrix[2][0] = 0.0;
-    rot_matrix[2][1] = 0.0;
-    rot_matrix[2][2] = 1.0;
+    rotation_matrix(angle, rot_matrix);
 
     translation_vec[0] = x;
     translation_vec[1] = y;
     translation_vec[2] = 0.0; // z is always zero - Model "lives" only in 2D
 
-    // transforming to the new model:
-    triangles_transformed = triangles;
-    for (Triangle_2D &triangle : triangles_transformed) {
-        transform_triangle(triangle);
+    transformed_valid.store(false, std::memory_order_relaxed);
+}
+
+bool Model_2D::collides_with(const Model_2D &other_model) const {
+    double rot[3][3];
+    double trans[3] = {translation_vec[0], translation_vec[1], translation_vec[2]};
+    std::copy(&rot_matrix[0][0], &rot_matrix[0][0] + 9, &rot[0][0]);
+    return collides_with(rot, trans, other_model, RAPID_FIRST_CONTACT);
+}
+
+bool Model_2D::collides_with(double x, double y, double angle, const Model_2D &other_model) const {
+    double rot[3][3];
+    double trans[3] = {x, y, 0.0};
+    rotation_matrix(angle, rot);
+    return collides_with(rot, trans, other_model, RAPID_FIRST_CONTACT);
+}
+
+int Model_2D::collides_with_batch(const double poses[], int count, const Model_2D &other_model) const {
+    // poses transposed to the lanes (unused lanes repeat the first pose):
+    double x[BATCH_SIZE], y[BATCH_SIZE], cos_angle[BATCH_SIZE], sin_angle[BATCH_SIZE];
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        const double *pose = poses + 3 * (lane < count ? lane : 0);
+        x[lane] = pose[0];
+        y[lane] = pose[1];
+        cos_angle[lane] = std::cos(pose[2]);
+        sin_angle[lane] = std::sin(pose[2]);
+    }
+    Lanes lanes_x = Lanes::load(x), lanes_y = Lanes::load(y);
+    Lanes lanes_cos = Lanes::load(cos_angle), lanes_sin = Lanes::load(sin_angle);
+
+    // other model at it's current pose (obstacles don't move, so it's transformed only once):
+    other_model.update_transformed();
+    const std::vector<Triangle_2D> &other_triangles = other_model.triangles_transformed;
+
+    collision_stats.queries += count;
+    int all = (1 << count) - 1;
+    int colliding = 0;
+    for (const Triangle_2D &triangle : triangles) {
+        Lanes px[3], py[3]; // vertices of the triangle at all poses
+        for (int i = 0; i < 3; i++) {
+            Lanes local_x = Lanes::set(triangle.vertices[i].get_x());
+            Lanes local_y = Lanes::set(triangle.vertices[i].get_y());
+            px[i] = lanes_cos * local_x - lanes_sin * local_y + lanes_x;
+            py[i] = lanes_sin * local_x + lanes_cos * local_y + lanes_y;
+        }
+
+        for (const Triangle_2D &other : other_triangles) {
+            collision_stats.tri_tests++;
+            int separated_lanes = 0;
+            // axes perpendicular to the edges of the other triangle (same in all lanes):
+            for (int i = 0; i < 3; i++) {
+                const Point_2D &a = other.vertices[i];
+                const Point_2D &b = other.vertices[(i + 1) % 3];
+                double nx = a.get_y() - b.get_y();
+                double ny = b.get_x() - a.get_x();
+                double q[3];
+                for (int j = 0; j < 3; j++) {
+                    q[j] = nx * other.vertices[j].get_x() + ny * other.vertices[j].get_y();
+                }
+                Lanes lanes_nx = Lanes::set(nx), lanes_ny = Lanes::set(ny);
+                Lanes p0 = lanes_nx * px[0] + lanes_ny * py[0];
+                Lanes p1 = lanes_nx * px[1] + lanes_ny * py[1];
+                Lanes p2 = lanes_nx * px[2] + lanes_ny * py[2];
+                separated_lanes |= separated(min(min(p0, p1), p2), max(max(p0, p1), p2),
+                                             Lanes::set(std::min({q[0], q[1], q[2]})),
+                                             Lanes::set(std::max({q[0], q[1], q[2]})));
+            }
+            // axes perpendicular to the edges of this triangle (different in every lane):
+            for (int i = 0; i < 3 && separated_lanes != all; i++) {
+                Lanes nx = py[i] - py[(i + 1) % 3];
+                Lanes ny = px[(i + 1) % 3] - px[i];
+                Lanes p0 = nx * px[0] + ny * py[0];
+                Lanes p1 = nx * px[1] + ny * py[1];
+                Lanes p2 = nx * px[2] + ny * py[2];
+                Lanes q0 = nx * Lanes::set(other.vertices[0].get_x()) + ny * Lanes::set(other.vertices[0].get_y());
+                Lanes q1 = nx * Lanes::set(other.vertices[1].get_x()) + ny * Lanes::set(other.vertices[1].get_y());
+                Lanes q2 = nx * Lanes::set(other.vertices[2].get_x()) + ny * Lanes::set(other.vertices[2].get_y());
+                separated_lanes |= separated(min(min(p0, p1), p2), max(max(p0, p1), p2), min(min(q0, q1), q2),
+                                             max(max(q0, q1), q2));
+            }
+
+            colliding |= ~separated_lanes & all;
+            if (colliding == all) {
+                return colliding;
+            }
+        }
     }
+    return colliding;
 }
 
-bool Model_2D::collides_with(Model_2D &other_model) {
-    RAPID_Collide(rot_matrix, translation_vec, rapid_model.get(), other_model.rot_matrix, other_model.translation_vec,
-                  other_model.rapid_model.get());
-    return RAPID_num_contacts != 0;
+double Model_2D::distance_to(double x, double y, double angle, const Model_2D &other_model, double range,
+                             double threshold) const {
+    // scratch buffers of this model transformed to the pose (kept between the calls, so the query doesn't allocate):
+    thread_local std::vector<Triangle_2D> triangles_a;
+    thread_local std::vector<Box_2D> boxes_a;
+
+    double rot[3][3];
+    double trans[3] = {x, y, 0.0};
+    rotation_matrix(angle, rot);
+    transform(triangles, rot, trans, triangles_a, boxes_a);
+    other_model.update_transformed(); // other model at it's current pose
+    const std::vector<Triangle_2D> &triangles_b = other_model.triangles_transformed;
+    const std::vector<Box_2D> &boxes_b = other_model.boxes_transformed;
+
+    double distance = range;
+    for (size_t i = 0; i < triangles_a.size(); i++) {
+        for (size_t j = 0; j < triangles_b.size(); j++) {
+            if (box_distance(boxes_a[i], boxes_b[j]) >= distance) {
+                continue; // triangles can't be closer than the best pair so far
+            }
+            distance = std::min(distance, triangle_distance(triangles_a[i], triangles_b[j]));
+            if (distance == 0.0 || distance < threshold) {
+                return distance; // models collide or the caller doesn't need the exact distance
+            }
+        }
+    }
+    return distance;
 }
 
+bool Model_2D::get_contacts(const Model_2D &other_model, std::vector<Contact> &contacts) const {
+    double rot[3][3];
+    double trans[3] = {translation_vec[0], translation_vec[1], translation_vec[2]};
+    std::copy(&rot_matrix[0][0], &rot_matrix[0][0] + 9, &rot[0][0]);
+    return get_contacts(rot, trans, other_model, contacts);
+}
+
+bool Model_2D::get_contacts(double x, double y, double angle, const Model_2D &other_model,
+                            std::vector<Contact> &contacts) const {
+    double rot[3][3];
+    double trans[3] = {x, y, 0.0};
+    rotation_matrix(angle, rot);
+    return get_contacts(rot, trans, other_model, contacts);
+}
+
+const Model_2D::Collision_stats &Model_2D::get_collision_stats() { return collision_stats; }
+
+void Model_2D::reset_collision_stats() { collision_stats = Collision_stats(); }
+
 void Model_2D::set_color(const Color &color) { this->color = color; }
 
 Color Model_2D::get_color() const { return color; }
 
-const std::vector<Triangle_2D> &Model_2D::get_model() const { return triangles_transformed; }
+const std::vector<Triangle_2D> &Model_2D::get_model() const {
+    update_transformed();
+    return triangles_transformed;
+}
+
+Box_2D Model_2D::get_bounding_box() const { return bounding_box(triangles, rot_matrix, translation_vec); }
+
+Box_2D Model_2D::get_bounding_box(double x, double y, double angle) const {
+    double rot[3][3];
+    double trans[3] = {x, y, 0.0};
+    rotation_matrix(angle, rot);
+    return bounding_box(triangles, rot, trans);
+}
+
+/**
+ * Computes 3D rotation matrix for the rotation around the z axis.
+ */
+void Model_2D::rotation_matrix(double angle, double matrix[3][3]) {
+    matrix[0][0] = cos(angle);
+    matrix[0][1] = -1.0 * sin(angle);
+    matrix[0][2] = 0.0;
+    matrix[1][0] = sin(angle);
+    matrix[1][1] = cos(angle);
+    matrix[1][2] = 0.0;
+    matrix[2][0] = 0.0;
+    matrix[2][1] = 0.0;
+    matrix[2][2] = 1.0;
+}
+
+void Model_2D::transform(const std::vector<Triangle_2D> &triangles, const double rot[3][3], const double trans[3],
+                         std::vector<Triangle_2D> &transformed, std::vector<Box_2D> &boxes) {
+    transformed.assign(triangles.begin(), triangles.end());
+    boxes.clear();
+    for (Triangle_2D &triangle : transformed) {
+        Box_2D box = {Point_2D(INFINITY, INFINITY), Point_2D(-INFINITY, -INFINITY)};
+        for (Point_2D &point : triangle.vertices) {
+            double x = point.get_x();
+            double y = point.get_y();
+            point.set_x(rot[0][0] * x + rot[0][1] * y + trans[0]);
+            point.set_y(rot[1][0] * x + rot[1][1] * y + trans[1]);
+            box.min = Point_2D(std::min(box.min.get_x(), point.get_x()), std::min(box.min.get_y(), point.get_y()));
+            box.max = Point_2D(std::max(box.max.get_x(), point.get_x()), std::max(box.max.get_y(), point.get_y()));
+        }
+        boxes.push_back(box);
+    }
+}
 
 /**
- * Transforms given triangle according to the current rot_matrix and translation_vec
+ * Checks collision of this model transformed by rot and trans with the other model at it's current pose (flag is
+ * passed to RAPID_Collide). RAPID only reads the models and it's report fields are thread local, so the check is
+ * reentrant.
  */
-void Model_2D::transform_triangle(Triangle_2D &triangle) {
-    for (Point_2D &point : triangle.vertices) {
-        double x = point.get_x();
-        double y = point.get_y();
-        point.set_x(rot_matrix[0][0] * x + rot_matrix[0][1] * y + translation_vec[0]);
-        point.set_y(rot_matrix[1][0] * x + rot_matrix[1][1] * y + translation_vec[1]);
+bool Model_2D::collides_with(double rot[3][3], double trans[3], const Model_2D &other_model, int flag) const {
+    double other_rot[3][3];
+    double other_trans[3] = {other_model.translation_vec[0], other_model.translation_vec[1],
+                             other_model.translation_vec[2]};
+    std::copy(&other_model.rot_matrix[0][0], &other_model.rot_matrix[0][0] + 9, &other_rot[0][0]);
+    RAPID_Collide(rot, trans, rapid_model.get(), other_rot, other_trans, other_model.rapid_model.get(), flag);
+
+    collision_stats.queries++;
+    collision_stats.box_tests += RAPID_num_box_tests;
+    collision_stats.tri_tests += RAPID_num_tri_tests;
+    return RAPID_num_contacts != 0;
+}
+
+/**
+ * Collects all contacts of this model transformed by rot and trans with the other model at it's current pose.
+ */
+bool Model_2D::get_contacts(double rot[3][3], double trans[3], const Model_2D &other_model,
+                            std::vector<Contact> &contacts) const {
+    contacts.clear();
+    bool collides = collides_with(rot, trans, other_model, RAPID_ALL_CONTACTS);
+    for (int i = 0; i < RAPID_num_contacts; i++) {
+        contacts.push_back({RAPID_contact[i].id1, RAPID_contact[i].id2});
+    }
+    return collides;
+}
+
+/**
+ * Computes the bounding box of the triangles transformed by rot and trans.
+ */
+Box_2D Model_2D::bounding_box(const std::vector<Triangle_2D> &triangles, const double rot[3][3],
+                              const double trans[3]) {
+    Box_2D box = {Point_2D(INFINITY, INFINITY), Point_2D(-INFINITY, -INFINITY)};
+    for (const Triangle_2D &triangle : triangles) {
+        for (const Point_2D &point : triangle.vertices) {
+            double x = rot[0][0] * point.get_x() + rot[0][1] * point.get_y() + trans[0];
+            double y = rot[1][0] * point.get_x() + rot[1][1] * point.get_y() + trans[1];
+            box.min = Point_2D(std::min(box.min.get_x(), x), std::min(box.min.get_y(), y));
+            box.max = Point_2D(std::max(box.max.get_x(), x), std::max(box.max.get_y(), y));
+        }
+    }
+    return box;
+}
+
+void Model_2D::update_transformed() const {
+    if (transformed_valid.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(transform_mutex);
+    if (!transformed_valid.load(std::memory_order_relaxed)) { // other thread could transform it in the meantime
+        // vectors keep their memory, so no allocation is needed after the first transformation:
+        transform(triangles, rot_matrix, translation_vec, triangles_transformed, boxes_transformed);
+        transformed_valid.store(true, std::memory_order_release);
     }
 }
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <RAPID.H>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "graphic_primitives.hpp"
@@ -10,12 +15,33 @@
  * Class representing a model in a two dimensinal world consisting of triangles.
  */
 class Model_2D {
+  public:
+    /** Counters of the RAPID collision queries (accumulated per thread). */
+    struct Collision_stats {
+        uint64_t queries = 0;
+        uint64_t box_tests = 0; // bounding volume overlap tests
+        uint64_t tri_tests = 0; // triangle intersection tests
+    };
+
+    /** Pair of the colliding triangles - index of the triangle of this model and index of the triangle of the other */
+    typedef std::pair<int, int> Contact;
+
+    /** Number of poses checked at once by collides_with_batch (lanes of the SIMD registers). */
+    static constexpr int BATCH_SIZE = 4;
+
   private:
+    static thread_local Collision_stats collision_stats;
+
     std::vector<Triangle_2D> triangles;
-    std::vector<Triangle_2D> triangles_transformed; // triangles model transformed according to the rotation
-                                                    // and translation
+    // triangles model transformed according to the rotation and translation and their bounding boxes - computed
+    // lazily by update_transformed (needed by the rendering and by the queries against the model at it's current pose):
+    mutable std::vector<Triangle_2D> triangles_transformed;
+    mutable std::vector<Box_2D> boxes_transformed;
+    mutable std::atomic<bool> transformed_valid{false}; // false if the pose changed since the last transformation
+    mutable std::mutex transform_mutex;                 // the first query after a move can come from multiple threads
 
-    Color color; // color of the model
+    Color color;   // color of the model
+    double radius; // distance of the furthest vertex from the origin of the model
 
     double rot_matrix[3][3];   // rotation matrix (defines current rotation of the model in the world)
     double translation_vec[3]; // current model position in the world (3rd coordinate is always zero)
@@ -28,15 +54,61 @@ class Model_2D {
     Model_2D() = delete; // model should be initalized with the triangles parameter (see other contructor)
     Model_2D(const std::vector<Triangle_2D> &triangles, const Color &color);
 
-    /** Rotates the model by the angle and places it in the word at (x, y) coordinates */
+    /** Rotates the model by the angle and places it in the word at (x, y) coordinates (only updates the pose, geometry
+     * is not transformed until get_model is called) */
     void move(double x, double y, double angle);
-    /** Checks collision between models and returns true if they collide, false if not. */
-    bool collides_with(Model_2D &other_model);
+    /** Checks collision between models and returns true if they collide, false if not. The check stops at the first
+     * found contact. */
+    bool collides_with(const Model_2D &other_model) const;
+    /** Checks collision between this model placed at the given pose (instead of it's current one) and the other model.
+     * Does not modify any of the models, so it can be called from multiple threads at once. */
+    bool collides_with(double x, double y, double angle, const Model_2D &other_model) const;
+    /** Checks collision between this model placed at up to BATCH_SIZE poses and the other model. Poses are [x, y,
+     * angle] triples stored one after another. Instead of RAPID, the models are checked as 2D triangle soups by the
+     * separating axis test running all poses at once in SIMD lanes (AVX if enabled at compile time). Returns the bit
+     * mask of the colliding poses (bit i set if the model collides at the i-th pose). Thread safe as collides_with. */
+    int collides_with_batch(const double poses[], int count, const Model_2D &other_model) const;
+    /** Returns the distance between this model placed at the given pose and the other model at it's current pose (zero
+     * if they collide). Pairs of triangles further than the range are not examined - the range is returned if the
+     * models are not closer. If the threshold is positive, the search stops at the first pair of triangles closer than
+     * the threshold (their distance is returned). Does not modify any of the models, so it can be called from multiple
+     * threads at once. */
+    double distance_to(double x, double y, double angle, const Model_2D &other_model, double range = INFINITY,
+                       double threshold = 0.0) const;
+    /** Finds all pairs of colliding triangles of the models (slower than collides_with, which stops at the first
+     * contact). Returns true if the models collide. */
+    bool get_contacts(const Model_2D &other_model, std::vector<Contact> &contacts) const;
+    /** Same as get_contacts above with this model placed at the given pose. */
+    bool get_contacts(double x, double y, double angle, const Model_2D &other_model,
+                      std::vector<Contact> &contacts) const;
+    /** Returns counters of the collision queries made by the calling thread. */
+    static const Collision_stats &get_collision_stats();
+    /** Resets counters of the collision queries made by the calling thread. */
+    static void reset_collision_stats();
     void set_color(const Color &color);
     Color get_color() const;
-    /** Returns the transformed triangles */
+    /** Returns the transformed triangles (transforms them first if the pose changed since the last call - so it must
+     * not be called at the same time as move) */
     const std::vector<Triangle_2D> &get_model() const;
+    /** Returns the triangles of the model in it's local coordinates (not transformed by the pose). */
+    const std::vector<Triangle_2D> &get_triangles() const { return triangles; }
+    /** Returns the distance of the furthest vertex of the model from it's origin (the center of rotation). */
+    double get_radius() const { return radius; }
+    /** Returns the axis aligned bounding box of the model at it's current pose. */
+    Box_2D get_bounding_box() const;
+    /** Returns the axis aligned bounding box of the model placed at the given pose (instead of it's current one). */
+    Box_2D get_bounding_box(double x, double y, double angle) const;
 
   private:
-    void transform_triangle(Triangle_2D &triangle);
+    /** Transforms the triangles and their bounding boxes to the current pose if it changed since the last call. */
+    void update_transformed() const;
+    static Box_2D bounding_box(const std::vector<Triangle_2D> &triangles, const double rot[3][3],
+                               const double trans[3]);
+    static void rotation_matrix(double angle, double matrix[3][3]);
+    /** Transforms the triangles by rot and trans and stores them to transformed (and their bounding boxes to boxes). */
+    static void transform(const std::vector<Triangle_2D> &triangles, const double rot[3][3], const double trans[3],
+                          std::vector<Triangle_2D> &transformed, std::vector<Box_2D> &boxes);
+    bool collides_with(double rot[3][3], double trans[3], const Model_2D &other_model, int flag) const;
+    bool get_contacts(double rot[3][3], double trans[3], const Model_2D &other_model,
+                      std::vector<Contact> &contacts) const;
 };
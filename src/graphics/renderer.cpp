@@ -1,4 +1,7 @@
 #include "renderer.hpp"
+#include "trace.hpp"
+
+#include <cmath>
 
 #define MSF_GIF_IMPL
 #include "msf_gif.h"
@@ -47,7 +50,10 @@ void Renderer::draw_point(const Point_2D &point, double radius, const Color &col
     cairo_fill(cr);
 }
 
-void Renderer::save_to_png(const char *file_name) { cairo_surface_write_to_png(surface, file_name); }
+void Renderer::save_to_png(const char *file_name) {
+    Trace_scope trace("save_png", "render");
+    cairo_surface_write_to_png(surface, file_name);
+}
 
 void Renderer::start_gif() {
     gif_state = {};
@@ -56,11 +62,13 @@ void Renderer::start_gif() {
 }
 
 void Renderer::add_to_gif(int centi_seconds) {
+    Trace_scope trace("gif_frame", "render"); // frames are quantized and compressed when added
     unsigned char *data = cairo_image_surface_get_data(surface);
     msf_gif_frame(&gif_state, data, centi_seconds, 16, image_width * 4);
 }
 
 void Renderer::save_gif(const char *filename) {
+    Trace_scope trace("save_gif", "render");
     MsfGifResult result = msf_gif_end(&gif_state);
     if (result.data) {
         FILE *fp = fopen(filename, "wb");
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Append-only pool of elements addressed by 32-bit indices. Elements are stored in fixed-size contiguous blocks, so
+ * they never move once they are added (references and pointers to them stay valid while the pool grows). clear() only
+ * resets the element count - the allocated blocks are kept and reused by the following push_back calls.
+ *
+ * @tparam T type of the stored elements (should be trivially copyable - elements are never destructed one by one)
+ * @tparam BLOCK_BITS log2 of the number of elements in one block
+ */
+template <typename T, size_t BLOCK_BITS = 12> class Arena {
+  private:
+    static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_BITS;
+    static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    std::vector<std::unique_ptr<T[]>> blocks;
+    size_t count = 0;
+
+  public:
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /** Adds copy of the element at the end of the pool and returns it's index. */
+    uint32_t push_back(const T &element) {
+        if ((count >> BLOCK_BITS) == blocks.size()) {
+            blocks.push_back(std::make_unique<T[]>(BLOCK_SIZE));
+        }
+        (*this)[count] = element;
+        return (uint32_t)count++;
+    }
+
+    T &operator[](size_t index) { return blocks[index >> BLOCK_BITS][index & BLOCK_MASK]; }
+    const T &operator[](size_t index) const { return blocks[index >> BLOCK_BITS][index & BLOCK_MASK]; }
+
+    T &back() { return (*this)[count - 1]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /** Removes all elements in O(1), allocated memory is kept for reuse. */
+    void clear() { count = 0; }
+};
@@ -5,16 +5,17 @@
 #include <iostream>
 
 /**
- * Template functions to perform standard vector operations (+, -, norm, distance, scalar multiplication) on
- * std::array's.
+ * Template functions to perform standard vector operations (+, -, dot, norm, distance, scalar multiplication) on
+ * std::array's. All loops run over the compile time size of the arrays, so the compiler unrolls (and vectorizes) them
+ * for every dimension. Functions without square root are constexpr.
  */
 
 /**
  * Returns result of vector addition.
  */
 template <size_t N>
-std::array<double, N> vector_add(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
-    std::array<double, N> res;
+constexpr std::array<double, N> vector_add(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
+    std::array<double, N> res{};
     for (size_t i = 0; i < N; i++) {
         res[i] = vec1[i] + vec2[i];
     }
@@ -25,38 +26,73 @@ std::array<double, N> vector_add(const std::array<double, N> &vec1, const std::a
  * Returns result of vector difference.
  */
 template <size_t N>
-std::array<double, N> vector_diff(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
-    std::array<double, N> res;
+constexpr std::array<double, N> vector_diff(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
+    std::array<double, N> res{};
     for (size_t i = 0; i < N; i++) {
         res[i] = vec1[i] - vec2[i];
     }
     return res;
 }
 
+/**
+ * Returns the dot product of vectors.
+ */
+template <size_t N> constexpr double vector_dot(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
+    double dot = 0.0;
+    for (size_t i = 0; i < N; i++) {
+        dot += vec1[i] * vec2[i];
+    }
+    return dot;
+}
+
+/**
+ * Returns the squared Euclidean norm of a vector.
+ */
+template <size_t N> constexpr double vector_norm_sq(const std::array<double, N> &vec) { return vector_dot(vec, vec); }
+
 /**
  * Returns the Euclidean norm of a vector.
  */
-template <size_t N> double vector_norm(const std::array<double, N> &vec) {
-    double norm = 0.0;
+template <size_t N> double vector_norm(const std::array<double, N> &vec) { return std::sqrt(vector_norm_sq(vec)); }
+
+/**
+ * Returns squared Euclidean distance between vectors (use it instead of vector_distance for comparisons).
+ */
+template <size_t N>
+constexpr double vector_distance_sq(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
+    double distance = 0.0;
     for (size_t i = 0; i < N; i++) {
-        norm += vec[i] * vec[i];
+        double diff = vec1[i] - vec2[i];
+        distance += diff * diff;
     }
-    return std::sqrt(norm);
+    return distance;
 }
 
 /**
  * Returns Euclidean distance between vectors.
  */
 template <size_t N> double vector_distance(const std::array<double, N> &vec1, const std::array<double, N> &vec2) {
-    std::array<double, N> diff = vector_diff(vec1, vec2);
-    return vector_norm(diff);
+    return std::sqrt(vector_distance_sq(vec1, vec2));
+}
+
+/**
+ * Returns vec1 + scalar * vec2 (without the temporary array of vector_add(vec1, vector_mult(scalar, vec2))).
+ */
+template <size_t N>
+constexpr std::array<double, N> vector_add_scaled(const std::array<double, N> &vec1, double scalar,
+                                                  const std::array<double, N> &vec2) {
+    std::array<double, N> res{};
+    for (size_t i = 0; i < N; i++) {
+        res[i] = vec1[i] + scalar * vec2[i];
+    }
+    return res;
 }
 
 /**
  * Returns the product of a vector and scalar.
  */
-template <size_t N> std::array<double, N> vector_mult(double scalar, const std::array<double, N> &vec) {
-    std::array<double, N> res;
+template <size_t N> constexpr std::array<double, N> vector_mult(double scalar, const std::array<double, N> &vec) {
+    std::array<double, N> res{};
     for (size_t i = 0; i < N; i++) {
         res[i] = scalar * vec[i];
     }
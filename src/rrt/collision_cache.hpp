@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * Memoization of the collision queries made by the RRT_solver during one solve. Stores results of the segment
+ * validations (keyed on the pair of vertex ids - the segment is treated as undirected) and results of the single state
+ * checks (keyed on the exact coordinates of the state).
+ *
+ * @tparam dimension - number of dimensions of the configuration space
+ */
+template <int dimension> class Collision_cache {
+  public:
+    struct Stats {
+        size_t segment_hits = 0;
+        size_t segment_misses = 0;
+        size_t state_hits = 0;
+        size_t state_misses = 0;
+    };
+
+  private:
+    struct State_hash {
+        size_t operator()(const std::array<double, dimension> &state) const {
+            uint64_t hash = 14695981039346656037ull;
+            for (int i = 0; i < dimension; i++) {
+                // adding 0.0 turns -0.0 into 0.0 so equal states always have the same hash
+                hash = (hash ^ std::bit_cast<uint64_t>(state[i] + 0.0)) * 1099511628211ull;
+            }
+            return (size_t)hash;
+        }
+    };
+
+    std::unordered_map<uint64_t, bool> segments;
+    std::unordered_map<std::array<double, dimension>, bool, State_hash> states;
+    Stats stats;
+
+  public:
+    /**
+     * Looks up the result of the segment validation between vertices a and b.
+     *
+     * @return true if the result is cached (and stored in the is_free parameter), false otherwise
+     */
+    bool find_segment(uint32_t a, uint32_t b, bool &is_free) {
+        auto it = segments.find(segment_key(a, b));
+        if (it == segments.end()) {
+            stats.segment_misses++;
+            return false;
+        }
+        stats.segment_hits++;
+        is_free = it->second;
+        return true;
+    }
+
+    void store_segment(uint32_t a, uint32_t b, bool is_free) { segments[segment_key(a, b)] = is_free; }
+
+    /** Returns true if the segment between vertices a and b was already found colliding (does not count as a hit). */
+    bool is_known_colliding(uint32_t a, uint32_t b) const {
+        auto it = segments.find(segment_key(a, b));
+        return it != segments.end() && !it->second;
+    }
+
+    /**
+     * Looks up the result of the check_collision call for the state.
+     *
+     * @return true if the result is cached (and stored in the is_free parameter), false otherwise
+     */
+    bool find_state(const std::array<double, dimension> &state, bool &is_free) {
+        auto it = states.find(state);
+        if (it == states.end()) {
+            stats.state_misses++;
+            return false;
+        }
+        stats.state_hits++;
+        is_free = it->second;
+        return true;
+    }
+
+    void store_state(const std::array<double, dimension> &state, bool is_free) { states[state] = is_free; }
+
+    const Stats &get_stats() const { return stats; }
+
+    /** Removes cached results of the segment validations (needed when the vertex ids change). */
+    void clear_segments() { segments.clear(); }
+
+    /** Removes all cached results and resets the statistics. */
+    void clear() {
+        segments.clear();
+        states.clear();
+        stats = Stats();
+    }
+
+  private:
+    static uint64_t segment_key(uint32_t a, uint32_t b) {
+        return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+    }
+};
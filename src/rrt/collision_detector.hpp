@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * Scratch state of one thread for the reentrant Collision_detector::check_collision overload. Implementations of the
+ * Collision_detector can derive from it to keep their own per-thread data (see Collision_detector::create_context).
+ */
+struct Collision_context {
+    virtual ~Collision_context() = default;
+};
+
+/**
+ * Interface class to provide the rrt algorithm with a collision detection method
+ */
+class Collision_detector {
+  private:
+    std::unique_ptr<Collision_context> default_context; // context used by the non reentrant check_collision overload
+
+  public:
+    virtual ~Collision_detector() = default;
+
+    /**
+     * Checks if the given state (robot configuration) is permissible (robot does not collide with walls etc). Uses one
+     * context shared by all callers, so it must not be called from multiple threads at once.
+     *
+     * @return true if the state is permissible, false if the state is not allowed
+     */
+    bool check_collision(const double state[]) {
+        if (!default_context) {
+            default_context = create_context();
+        }
+        return check_collision(state, *default_context);
+    }
+
+    /**
+     * Reentrant version of check_collision. Implementations must not modify the detector - all mutable data of the
+     * query are kept in the context, so the method can be called from multiple threads at once as long as every thread
+     * uses it's own context.
+     *
+     * @param context scratch state created by the create_context method of this detector
+     * @return true if the state is permissible, false if the state is not allowed
+     */
+    virtual bool check_collision(const double state[], Collision_context &context) const = 0;
+
+    /**
+     * Checks a batch of states at once (non reentrant version - see the check_collision overload with the default
+     * context).
+     */
+    void check_collisions(const double states[], size_t count, size_t stride, bool results[]) {
+        if (!default_context) {
+            default_context = create_context();
+        }
+        check_collisions(states, count, stride, results, *default_context);
+    }
+
+    /**
+     * Checks a batch of states at once. Results are the same as of check_collision called for every state, but
+     * detectors can override the method with a faster batched check (the default implementation checks the states one
+     * by one). Reentrant in the same way as check_collision.
+     *
+     * @param states states stored one after another - the i-th state starts at states[i * stride]
+     * @param results results[i] is set to true if the i-th state is permissible, false if not
+     */
+    virtual void check_collisions(const double states[], size_t count, size_t stride, bool results[],
+                                  Collision_context &context) const {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = check_collision(states + i * stride, context);
+        }
+    }
+
+    /**
+     * Returns the distance between the robot in the given state and the nearest obstacle in the workspace (zero if the
+     * state is not permissible). The default implementation doesn't support the query and returns zero. Reentrant in
+     * the same way as check_collision.
+     *
+     * @param range obstacles further than the range don't have to be examined - the range is returned if no obstacle
+     * is closer (the query is faster for shorter ranges)
+     * @param threshold the query can stop as soon as it finds an obstacle closer than the threshold (the returned
+     * distance is then lower than the threshold, but it doesn't have to be the distance to the nearest obstacle), zero
+     * to always find the nearest obstacle
+     * @param closest set to the id of the (found) nearest obstacle, -1 if no obstacle is closer than the range or if
+     * the query is not supported
+     */
+    virtual double get_clearance(const double state[], Collision_context &context, double range, double threshold,
+                                 int &closest) const {
+        (void)state;
+        (void)context;
+        (void)range;
+        (void)threshold;
+        closest = -1;
+        return 0.0;
+    }
+
+    /**
+     * Returns the radius of a ball around the state (in the euclidean metric of the configuration space) containing
+     * only permissible states. Zero means that the state is not permissible or that the detector can't tell (the
+     * default implementation). Used by the conservative advancement validation of the paths (see
+     * RRT_solver::set_segment_validation), so the radius must never be overestimated. Reentrant in the same way as
+     * check_collision.
+     *
+     * @param min_radius radii up to min_radius are of no use to the caller - zero can be returned for them
+     */
+    virtual double get_free_radius(const double state[], Collision_context &context, double min_radius) const {
+        (void)state;
+        (void)context;
+        (void)min_radius;
+        return 0.0;
+    }
+
+    /**
+     * Creates new scratch context for the reentrant check_collision calls of one thread.
+     */
+    virtual std::unique_ptr<Collision_context> create_context() const { return std::make_unique<Collision_context>(); }
+};
@@ -1,111 +1,174 @@
 #pragma once
 
+#include "arena.hpp"
+#include "kd_tree.hpp"
 #include <array>
-#include <flann/flann.hpp>
-#include <list>
-#include <string.h>
+#include <cstdint>
+#include <limits>
 #include <utility>
 #include <vector>
 
 /**
  * Class representing a Tree generated by the RRT algorithm. Each vertex stores it's coordinations in the
  * configuraion space. Class is templated on the number of dimensions of the configuration space.
+ *
+ * Vertices are stored in structure-of-arrays form and are addressed by 32-bit indices (index of the vertex is also
+ * it's id). Children of each vertex are kept as an intrusive first child / next sibling list inside the same arrays, so
+ * the graph does not allocate per vertex and clear() only resets the pools.
  */
 template <int dimension> class Graph {
   public:
-    struct Vertex {
-        int id;
-        std::array<double, dimension> coords;
-        Vertex *parent;
-        std::list<std::pair<Vertex *, double>> edges; // outgoing edges with weights
-        double cost; // total cost of the path from the root of the graph to this vertex
-
-        Vertex(const std::array<double, dimension> &coords, Vertex *parent, double edge_weight_from_parent)
-            : coords(coords), parent(parent) {
-            id = last_vertex_id++;
-            if (parent == nullptr) {
-                cost = 0;
-            } else {
-                cost = parent->cost + edge_weight_from_parent;
-            }
-        }
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max(); // index of non-existent vertex
+
+    /**
+     * Lightweight handle to the vertex stored inside of the graph. Handles are cheap to copy and stay valid until the
+     * graph is cleared. Default constructed handle does not point to any vertex (evaluates to false).
+     */
+    class Vertex {
+      private:
+        const Graph *graph;
+        uint32_t index;
+
+      public:
+        Vertex() : graph(nullptr), index(NONE) {}
+
+        uint32_t id() const { return index; }
+        const std::array<double, dimension> &coords() const { return graph->coords[index]; }
+        /** Total cost of the path from the root of the graph to this vertex */
+        double cost() const { return graph->costs[index]; }
+        /** Weight of the edge from the parent vertex */
+        double weight() const { return graph->weights[index]; }
+        Vertex parent() const { return Vertex(graph, graph->parents[index]); }
+        Vertex first_child() const { return Vertex(graph, graph->first_children[index]); }
+        Vertex next_sibling() const { return Vertex(graph, graph->next_siblings[index]); }
+
+        explicit operator bool() const { return index != NONE; }
+        bool operator==(const Vertex &other) const { return index == other.index; }
+        bool operator!=(const Vertex &other) const { return index != other.index; }
+
+      private:
+        friend class Graph;
+        Vertex(const Graph *graph, uint32_t index) : graph(graph), index(index) {}
     };
 
-  public:
-    static int last_vertex_id;
-    std::vector<Vertex *> vertices;
-    flann::Index<flann::L2<double>> index; // index for nearest neighbour search
+  private:
+    // vertex data (structure of arrays indexed by the vertex id):
+    Arena<std::array<double, dimension>> coords; // arena keeps the coordinates on stable addresses
+    std::vector<uint32_t> parents;
+    std::vector<double> costs;   // total cost of the path from the root of the graph to the vertex
+    std::vector<double> weights; // weight of the edge from the parent
+    std::vector<uint32_t> first_children;
+    std::vector<uint32_t> next_siblings;
+
+    Kd_tree<dimension> index; // index for nearest neighbour search (point ids are equal to the vertex ids)
+
+    std::vector<uint32_t> stack; // scratch stack for the subtree traversals
 
   public:
     Graph(const Graph &) = delete;
     Graph &operator=(const Graph &) = delete;
 
-    Graph() : index(flann::KDTreeIndexParams(4)) {}
-
-    Graph(std::array<double, dimension> &root_coords) : index(flann::KDTreeIndexParams(4)) {
-        // building flann index:
-        flann::Matrix<double> point_matrix(root_coords.data(), 1, dimension);
-        index.buildIndex(point_matrix);
-
-        Vertex *root = new Vertex(root_coords);
-        vertices.push_back(root);
-    }
-
-    ~Graph() {
-        for (size_t i = 0; i < vertices.size(); i++) {
-            delete vertices[i];
-        }
-    }
+    Graph() {}
 
-    Vertex *add_vertex(std::array<double, dimension> &coords, Vertex *parent, double weight) {
-        if (vertices.empty()) {
-            // building new flann index for the first vertex
-            flann::Matrix<double> point_matrix(coords.data(), 1, dimension);
-            index.buildIndex(point_matrix);
-        } else {
-            // otherwise adding to existing flann index
-            flann::Matrix<double> point_matrix(coords.data(), 1, dimension);
-            index.addPoints(point_matrix, 2);
-        }
+    Graph(const std::array<double, dimension> &root_coords) { add_vertex(root_coords); }
 
-        // crating new vertex
-        Vertex *new_vertex = new Vertex(coords, parent, weight);
-        vertices.push_back(new_vertex);
+    Vertex add_vertex(const std::array<double, dimension> &new_coords, Vertex parent, double weight) {
+        uint32_t id = coords.push_back(new_coords);
+        parents.push_back(parent.index);
+        costs.push_back(parent ? costs[parent.index] + weight : 0.0);
+        weights.push_back(parent ? weight : 0.0);
+        first_children.push_back(NONE);
+        next_siblings.push_back(NONE);
+        index.insert(new_coords);
 
-        return new_vertex;
+        return Vertex(this, id);
     }
 
-    Vertex *add_vertex(std::array<double, dimension> &coords) { return add_vertex(coords, nullptr, 0); }
+    Vertex add_vertex(const std::array<double, dimension> &new_coords) { return add_vertex(new_coords, Vertex(), 0); }
 
-    void add_edge(Vertex *from, Vertex *to, double weight) {
-        from->edges.push_back(std::pair<Vertex *, double>(to, weight));
+    /**
+     * Adds the edge to the list of outgoing edges (children) of the from vertex.
+     */
+    void add_edge(Vertex from, Vertex to, double weight) {
+        weights[to.index] = weight;
+        next_siblings[to.index] = first_children[from.index];
+        first_children[from.index] = to.index;
     }
 
-    void remove_edge(Vertex *from, Vertex *to) {
-        for (typename std::list<std::pair<Vertex *, double>>::iterator it = from->edges.begin();
-             it != from->edges.end();) {
-            if ((*it).first == to) {
-                from->edges.erase(it);
+    void remove_edge(Vertex from, Vertex to) {
+        uint32_t *link = &first_children[from.index];
+        while (*link != NONE) {
+            if (*link == to.index) {
+                *link = next_siblings[to.index];
+                next_siblings[to.index] = NONE;
                 break;
             }
-            it++;
+            link = &next_siblings[*link];
         }
     }
 
-    void rewire_vertex(Vertex *vertex, Vertex *new_parent, double new_edge_weight) {
-        if (vertex->parent != nullptr) {
-            remove_edge(vertex->parent, vertex);
+    /**
+     * Moves the vertex (with it's subtree) under the new parent. Costs of all descendants are updated in the same call,
+     * so costs in the graph are always consistent with the edges.
+     *
+     * @return number of descendants whose cost was updated (size of the rewire cascade)
+     */
+    size_t rewire_vertex(Vertex vertex, Vertex new_parent, double new_edge_weight) {
+        if (parents[vertex.index] != NONE) {
+            remove_edge(Vertex(this, parents[vertex.index]), vertex);
         }
-        vertex->parent = new_parent;
+        parents[vertex.index] = new_parent.index;
         add_edge(new_parent, vertex, new_edge_weight);
-        vertex->cost = new_parent->cost + new_edge_weight;
+        double new_cost = costs[new_parent.index] + new_edge_weight;
+        if (new_cost == costs[vertex.index]) {
+            return 0; // descendants are up to date
+        }
+        costs[vertex.index] = new_cost;
+        return update_subtree_costs(vertex);
+    }
+
+    /**
+     * Removes the edge from the parent of the vertex. The vertex and it's whole subtree become unreachable from the
+     * root (their cost is set to infinity) until the vertex is rewired to another parent.
+     */
+    void detach_vertex(Vertex vertex) {
+        if (parents[vertex.index] != NONE) {
+            remove_edge(Vertex(this, parents[vertex.index]), vertex);
+            parents[vertex.index] = NONE;
+        }
+        costs[vertex.index] = std::numeric_limits<double>::infinity();
+        update_subtree_costs(vertex);
+    }
+
+    /**
+     * Recomputes costs of all descendants of the vertex from the cost of the vertex and the edge weights (the cost
+     * change of the vertex is propagated down the subtree in one depth first pass). Returns the number of the updated
+     * descendants.
+     */
+    size_t update_subtree_costs(Vertex vertex) {
+        size_t updated = 0;
+        stack.clear();
+        stack.push_back(vertex.index);
+        while (!stack.empty()) {
+            uint32_t current = stack.back();
+            stack.pop_back();
+            double cost = costs[current];
+            for (uint32_t child = first_children[current]; child != NONE; child = next_siblings[child]) {
+                costs[child] = cost + weights[child];
+                if (first_children[child] != NONE) { // leaves don't need to be visited
+                    stack.push_back(child);
+                }
+                updated++;
+            }
+        }
+        return updated;
     }
 
     /**
      * Adds new vertex to the graph together with the edge from the parent vertex
      */
-    Vertex *connect_new_vertex(std::array<double, dimension> &coords, Vertex *parent, double weight) {
-        Vertex *new_vertex = add_vertex(coords, parent, weight);
+    Vertex connect_new_vertex(const std::array<double, dimension> &new_coords, Vertex parent, double weight) {
+        Vertex new_vertex = add_vertex(new_coords, parent, weight);
         add_edge(parent, new_vertex, weight);
         return new_vertex;
     }
@@ -113,69 +176,110 @@ template <int dimension> class Graph {
     /**
      * Returns nearest vertex (in standard Euclidean distance) to the query configuration.
      */
-    Vertex *get_nearest(std::array<double, dimension> &query_coords) {
-        flann::Matrix<double> query_point(query_coords.data(), 1, dimension);
-
-        std::vector<std::vector<int>> indices;
-        std::vector<std::vector<double>> dists;
-        index.knnSearch(query_point, indices, dists, 1, flann::SearchParams(128));
-
-        return vertices[indices[0][0]];
+    Vertex get_nearest(const std::array<double, dimension> &query_coords) const {
+        return Vertex(this, index.nearest(query_coords));
     }
 
     /**
      * Returns (via std::vector reference) k nearest vertices (in standard Euclidean distance) to the query
-     * configuration.
+     * configuration. Vertices are sorted by the distance, if the graph has less than k vertices, all of them are
+     * returned.
      */
-    void get_k_nearest(std::vector<Vertex *> &k_nearest, std::array<double, dimension> &query_coords, size_t k) {
-        if (k <= 0) {
-            return;
-        }
-
-        if (k > vertices.size()) {
-            k = vertices.size() - 1;
-        }
-        flann::Matrix<double> query_point(query_coords.data(), 1, dimension);
-
-        std::vector<std::vector<int>> indices;
-        std::vector<std::vector<double>> dists;
-        int found = index.knnSearch(query_point, indices, dists, k, flann::SearchParams(128));
-
-        for (int i = 0; i < found; i++) {
-            k_nearest.push_back(vertices[indices[0][i]]);
+    void get_k_nearest(std::vector<Vertex> &k_nearest, const std::array<double, dimension> &query_coords, size_t k) {
+        for (const std::pair<double, uint32_t> &neighbour : index.k_nearest(query_coords, k)) {
+            k_nearest.push_back(Vertex(this, neighbour.second));
         }
     }
 
+    /**
+     * Returns vertex with the given id (ids are assigned from zero in the order in which the vertices were added).
+     */
+    Vertex get_vertex(uint32_t id) const { return Vertex(this, id); }
+
     /**
      * Returns the last added vertex to the graph.
      */
-    Vertex *get_last() { return vertices.back(); }
+    Vertex get_last() const { return Vertex(this, (uint32_t)(size() - 1)); }
 
     /**
      * Returns the first added vertex to the graph.
      */
-    Vertex *get_root() const {
-        if (vertices.size() >= 1) {
-            return vertices[0];
+    Vertex get_root() const {
+        if (size() >= 1) {
+            return Vertex(this, 0);
         }
-        return nullptr;
+        return Vertex();
     }
 
     /**
-     * Removes all verticies and edges from the graph.
+     * Removes all vertices for which keep(vertex) returns false together with their subtrees (the root is always kept).
+     * Remaining vertices get new ids (handles and ids obtained before the call are invalidated).
+     *
+     * @param new_ids if not null, it's filled with the new id of every vertex (indexed by the old ids, NONE for the
+     * removed vertices)
+     * @return number of removed vertices
      */
-    void clear() {
-        for (size_t i = 0; i < vertices.size(); i++) {
-            delete vertices[i];
+    template <typename Keep> size_t prune(Keep keep, std::vector<uint32_t> *new_ids = nullptr) {
+        if (size() == 0) {
+            return 0;
         }
-        vertices.clear();
-        index = flann::Index<flann::L2<double>>(flann::KDTreeIndexParams(4)); // creating new index
+
+        // collecting kept vertices in preorder (so the parent of every vertex precedes it):
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> ids(size(), NONE);
+        stack.clear();
+        stack.push_back(0);
+        while (!stack.empty()) {
+            uint32_t current = stack.back();
+            stack.pop_back();
+            ids[current] = (uint32_t)order.size();
+            order.push_back(current);
+            for (uint32_t child = first_children[current]; child != NONE; child = next_siblings[child]) {
+                if (keep(Vertex(this, child))) {
+                    stack.push_back(child);
+                }
+            }
+        }
+
+        std::vector<std::array<double, dimension>> old_coords;
+        std::vector<uint32_t> old_parents;
+        std::vector<double> old_weights;
+        for (uint32_t old_id : order) {
+            old_coords.push_back(coords[old_id]);
+            old_parents.push_back(parents[old_id]);
+            old_weights.push_back(weights[old_id]);
+        }
+        size_t removed = size() - order.size();
+
+        clear();
+        for (size_t i = 0; i < order.size(); i++) {
+            if (old_parents[i] == NONE) {
+                add_vertex(old_coords[i]);
+            } else {
+                connect_new_vertex(old_coords[i], Vertex(this, ids[old_parents[i]]), old_weights[i]);
+            }
+        }
+        if (new_ids) {
+            *new_ids = std::move(ids);
+        }
+        return removed;
+    }
+
+    /**
+     * Removes all verticies and edges from the graph. Vertex pools keep their memory for the next use.
+     */
+    void clear() {
+        coords.clear();
+        parents.clear();
+        costs.clear();
+        weights.clear();
+        first_children.clear();
+        next_siblings.clear();
+        index.clear();
     }
 
     /**
      * Returns the number of verticies in the graph
      */
-    size_t size() { return vertices.size(); }
+    size_t size() const { return coords.size(); }
 };
-
-template <int dimension> int Graph<dimension>::last_vertex_id = 0;
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "array_math.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * Incremental bucketed k-d tree for exact nearest neighbour search (standard Euclidean distance).
+ *
+ * Points are inserted one by one and are never removed. New point is placed into the leaf bucket in which it belongs,
+ * a full bucket is split in two by the median of it's dimension with the largest spread. The tree is therefore never
+ * rebuilt and insertion or query does not allocate (apart from the amortized growth of the internal arrays).
+ *
+ * Invariant of every inner node: all points in the left subtree have coordinate split_dim <= split_value and all points
+ * in the right subtree have it >= split_value.
+ *
+ * @tparam dimension - number of dimensions of the indexed space
+ */
+template <int dimension> class Kd_tree {
+  public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+  private:
+    static constexpr uint32_t BUCKET_SIZE = 16;
+    static constexpr int LEAF = -1;
+
+    struct Node {
+        int split_dim;        // LEAF for leaf nodes
+        double split_value;   // inner nodes only
+        uint32_t children[2]; // inner nodes: left and right child, leaf nodes: children[0] is index of the bucket
+    };
+
+    struct Bucket {
+        uint32_t count;
+        uint32_t items[BUCKET_SIZE];
+    };
+
+    std::vector<std::array<double, dimension>> points; // indexed by the point id
+    std::vector<Node> nodes;                           // nodes[0] is the root
+    std::vector<Bucket> buckets;
+
+    std::vector<std::pair<double, uint32_t>> heap; // scratch max-heap of (squared distance, id) for k-NN queries
+
+  public:
+    /**
+     * Inserts the point into the tree and returns it's id (ids are assigned from zero in the order of insertion).
+     */
+    uint32_t insert(const std::array<double, dimension> &point) {
+        uint32_t id = (uint32_t)points.size();
+        points.push_back(point);
+
+        if (nodes.empty()) {
+            nodes.push_back({LEAF, 0.0, {new_bucket(), NONE}});
+        }
+
+        uint32_t node = 0;
+        while (true) {
+            while (nodes[node].split_dim != LEAF) {
+                const Node &inner = nodes[node];
+                node = inner.children[point[inner.split_dim] < inner.split_value ? 0 : 1];
+            }
+            Bucket &bucket = buckets[nodes[node].children[0]];
+            if (bucket.count < BUCKET_SIZE) {
+                bucket.items[bucket.count++] = id;
+                return id;
+            }
+            split(node); // full bucket -> splitting and descending from the same node again
+        }
+    }
+
+    /**
+     * Returns id of the point nearest to the query point (NONE if the tree is empty).
+     */
+    uint32_t nearest(const std::array<double, dimension> &query) const {
+        uint32_t best = NONE;
+        double best_dist = std::numeric_limits<double>::max();
+        if (!nodes.empty()) {
+            search_nearest(0, query, best, best_dist);
+        }
+        return best;
+    }
+
+    /**
+     * Finds min(k, size()) points nearest to the query point. Returns reference to the internal array of (squared
+     * distance, id) pairs sorted by the distance - the array is valid until the next k_nearest call.
+     */
+    const std::vector<std::pair<double, uint32_t>> &k_nearest(const std::array<double, dimension> &query, size_t k) {
+        heap.clear();
+        if (k > 0 && !nodes.empty()) {
+            search_k_nearest(0, query, k);
+        }
+        std::sort_heap(heap.begin(), heap.end());
+        return heap;
+    }
+
+    const std::array<double, dimension> &get_point(uint32_t id) const { return points[id]; }
+
+    size_t size() const { return points.size(); }
+
+    /** Removes all points, allocated memory is kept for reuse. */
+    void clear() {
+        points.clear();
+        nodes.clear();
+        buckets.clear();
+    }
+
+  private:
+    uint32_t new_bucket() {
+        buckets.push_back({0, {}});
+        return (uint32_t)(buckets.size() - 1);
+    }
+
+    void split(uint32_t node) {
+        Trace_scope trace("kd_split", "index");
+        uint32_t left_bucket = nodes[node].children[0];
+        uint32_t right_bucket = new_bucket();
+        Bucket &bucket = buckets[left_bucket];
+
+        // finding dimension with the largest spread:
+        int split_dim = 0;
+        double max_spread = -1.0;
+        for (int d = 0; d < dimension; d++) {
+            double min = std::numeric_limits<double>::max();
+            double max = std::numeric_limits<double>::lowest();
+            for (uint32_t i = 0; i < bucket.count; i++) {
+                double value = points[bucket.items[i]][d];
+                min = std::min(min, value);
+                max = std::max(max, value);
+            }
+            if (max - min > max_spread) {
+                max_spread = max - min;
+                split_dim = d;
+            }
+        }
+
+        std::sort(bucket.items, bucket.items + bucket.count,
+                  [&](uint32_t a, uint32_t b) { return points[a][split_dim] < points[b][split_dim]; });
+        uint32_t median = bucket.count / 2;
+
+        Bucket &right = buckets[right_bucket];
+        right.count = bucket.count - median;
+        std::copy(bucket.items + median, bucket.items + bucket.count, right.items);
+        bucket.count = median;
+
+        uint32_t left_node = (uint32_t)nodes.size();
+        nodes.push_back({LEAF, 0.0, {left_bucket, NONE}});
+        nodes.push_back({LEAF, 0.0, {right_bucket, NONE}});
+
+        Node &inner = nodes[node];
+        inner.split_dim = split_dim;
+        inner.split_value = points[right.items[0]][split_dim];
+        inner.children[0] = left_node;
+        inner.children[1] = left_node + 1;
+    }
+
+    double squared_distance(const std::array<double, dimension> &query, uint32_t id) const {
+        return vector_distance_sq(query, points[id]);
+    }
+
+    void search_nearest(uint32_t node, const std::array<double, dimension> &query, uint32_t &best,
+                        double &best_dist) const {
+        const Node &current = nodes[node];
+        if (current.split_dim == LEAF) {
+            const Bucket &bucket = buckets[current.children[0]];
+            for (uint32_t i = 0; i < bucket.count; i++) {
+                double dist = squared_distance(query, bucket.items[i]);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best = bucket.items[i];
+                }
+            }
+            return;
+        }
+
+        double diff = query[current.split_dim] - current.split_value;
+        int near = diff < 0.0 ? 0 : 1;
+        search_nearest(current.children[near], query, best, best_dist);
+        if (diff * diff < best_dist) {
+            search_nearest(current.children[1 - near], query, best, best_dist);
+        }
+    }
+
+    void search_k_nearest(uint32_t node, const std::array<double, dimension> &query, size_t k) {
+        const Node &current = nodes[node];
+        if (current.split_dim == LEAF) {
+            const Bucket &bucket = buckets[current.children[0]];
+            for (uint32_t i = 0; i < bucket.count; i++) {
+                double dist = squared_distance(query, bucket.items[i]);
+                if (heap.size() < k) {
+                    heap.push_back({dist, bucket.items[i]});
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (dist < heap.front().first) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = {dist, bucket.items[i]};
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+            return;
+        }
+
+        double diff = query[current.split_dim] - current.split_value;
+        int near = diff < 0.0 ? 0 : 1;
+        search_k_nearest(current.children[near], query, k);
+        if (heap.size() < k || diff * diff < heap.front().first) {
+            search_k_nearest(current.children[1 - near], query, k);
+        }
+    }
+};
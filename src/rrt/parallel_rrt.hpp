@@ -0,0 +1,76 @@
+#pragma once
+
+#include "rrt.hpp"
+#include "shared_bound.hpp"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/**
+ * OR-parallel wrapper of the RRT_solver - runs several independent trees (solvers with different seeds) on separate
+ * threads and returns the best of their plans. Solvers share the cost of the best path found so far: RRT trees stop as
+ * soon as any of them reaches the goal and RRT* trees use the shared cost to skip samples which can not improve it.
+ *
+ * The collision detector is queried from all threads at once through it's reentrant check_collision overload.
+ *
+ * @tparam dimension - number of dimensions of the configuration space
+ */
+template <int dimension> class Parallel_RRT_solver {
+  private:
+    std::vector<std::unique_ptr<RRT_solver<dimension>>> solvers; // one for every tree
+    Shared_bound bound;
+    size_t best = 0; // index of the solver which found the best plan in the previous solve
+
+  public:
+    /**
+     * @param boundaries bounds of the configuration space (see RRT_solver)
+     * @param detector implementation of the Collision_detector interface (must support reentrant queries)
+     * @param trees number of trees (and threads) - the calling thread grows the first tree
+     * @param seed seed of the first tree, following trees are seeded with seed + 1, seed + 2, ...
+     */
+    Parallel_RRT_solver(const std::array<std::array<double, 2>, dimension> &boundaries,
+                        const Collision_detector *detector, size_t trees, unsigned seed = 42);
+
+    /**
+     * Runs RRT_solver::solve_rrt on all trees. Plan of the tree which reached the goal first is returned (if more trees
+     * reached it at once, the shortest plan is returned). Parameters are the same as for RRT_solver::solve_rrt.
+     */
+    void solve_rrt(std::list<std::array<double, dimension>> &result_plan,
+                   const std::array<double, dimension> &start_state, const std::array<double, dimension> &goal_state,
+                   int iters, double delta);
+
+    /**
+     * Runs RRT_solver::solve_k_rrts on all trees and returns the shortest of their plans. Parameters are the same as
+     * for RRT_solver::solve_k_rrts (iters is the number of iterations of every tree).
+     */
+    void solve_k_rrts(std::list<std::array<double, dimension>> &result_plan,
+                      const std::array<double, dimension> &start_state, const std::array<double, dimension> &goal_state,
+                      int iters, double step, double delta);
+
+    /**
+     * Returns the tree which produced the result plan of the previous solve call.
+     */
+    Graph<dimension> &get_tree();
+
+    /**
+     * Returns the number of trees.
+     */
+    size_t size() const { return solvers.size(); }
+
+    /**
+     * Returns the time from the start of the previous solve to the first plan found by any of the trees
+     * (duration::max() if no tree found a plan).
+     */
+    std::chrono::steady_clock::duration get_first_solution_time() const;
+
+    /**
+     * Returns the number of iterations of all trees in the previous solve.
+     */
+    int get_iterations() const;
+
+  private:
+    /** Calls solve(solver, plan) for every solver on it's own thread and moves the shortest plan to result_plan. */
+    template <typename Solve> void run(std::list<std::array<double, dimension>> &result_plan, Solve solve);
+};
+
+#include "parallel_rrt.tpp"
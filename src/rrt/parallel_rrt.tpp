@@ -0,0 +1,94 @@
+#pragma once
+
+#include "parallel_rrt.hpp"
+#include <algorithm>
+#include <array_math.hpp>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+template <int dimension>
+Parallel_RRT_solver<dimension>::Parallel_RRT_solver(const std::array<std::array<double, 2>, dimension> &boundaries,
+                                                    const Collision_detector *detector, size_t trees, unsigned seed) {
+    for (size_t i = 0; i < std::max(trees, (size_t)1); i++) {
+        solvers.push_back(std::make_unique<RRT_solver<dimension>>(boundaries, detector));
+        solvers.back()->set_seed(seed + (unsigned)i);
+        solvers.back()->set_shared_bound(&bound);
+    }
+}
+
+template <int dimension>
+void Parallel_RRT_solver<dimension>::solve_rrt(std::list<std::array<double, dimension>> &result_plan,
+                                               const std::array<double, dimension> &start_state,
+                                               const std::array<double, dimension> &goal_state, int iters,
+                                               double delta) {
+    run(result_plan, [&](RRT_solver<dimension> &solver, std::list<std::array<double, dimension>> &plan) {
+        solver.solve_rrt(plan, start_state, goal_state, iters, delta);
+    });
+}
+
+template <int dimension>
+void Parallel_RRT_solver<dimension>::solve_k_rrts(std::list<std::array<double, dimension>> &result_plan,
+                                                  const std::array<double, dimension> &start_state,
+                                                  const std::array<double, dimension> &goal_state, int iters,
+                                                  double step, double delta) {
+    run(result_plan, [&](RRT_solver<dimension> &solver, std::list<std::array<double, dimension>> &plan) {
+        solver.solve_k_rrts(plan, start_state, goal_state, iters, step, delta);
+    });
+}
+
+template <int dimension> Graph<dimension> &Parallel_RRT_solver<dimension>::get_tree() {
+    return solvers[best]->get_tree();
+}
+
+template <int dimension>
+std::chrono::steady_clock::duration Parallel_RRT_solver<dimension>::get_first_solution_time() const {
+    std::chrono::steady_clock::duration first = std::chrono::steady_clock::duration::max();
+    for (const std::unique_ptr<RRT_solver<dimension>> &solver : solvers) {
+        first = std::min(first, solver->get_first_solution_time());
+    }
+    return first;
+}
+
+template <int dimension> int Parallel_RRT_solver<dimension>::get_iterations() const {
+    int iterations = 0;
+    for (const std::unique_ptr<RRT_solver<dimension>> &solver : solvers) {
+        iterations += solver->get_iterations();
+    }
+    return iterations;
+}
+
+template <int dimension>
+template <typename Solve>
+void Parallel_RRT_solver<dimension>::run(std::list<std::array<double, dimension>> &result_plan, Solve solve) {
+    bound.reset();
+
+    std::vector<std::list<std::array<double, dimension>>> plans(solvers.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < solvers.size(); i++) {
+        threads.emplace_back([&, i] { solve(*solvers[i], plans[i]); });
+    }
+    solve(*solvers[0], plans[0]);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    // choosing the shortest plan:
+    best = 0;
+    double min_length = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < plans.size(); i++) {
+        if (plans[i].empty()) {
+            continue;
+        }
+        double length = 0.0;
+        for (auto it = std::next(plans[i].begin()); it != plans[i].end(); it++) {
+            length += vector_distance(*std::prev(it), *it);
+        }
+        if (length < min_length) {
+            min_length = length;
+            best = i;
+        }
+    }
+
+    result_plan = std::move(plans[best]);
+}
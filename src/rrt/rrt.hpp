@@ -1,22 +1,22 @@
 #pragma once
 
+#include "collision_cache.hpp"
+#include "collision_detector.hpp"
 #include "graph.hpp"
+#include "safe_ball_cache.hpp"
+#include "shared_bound.hpp"
+#include "solve_profiler.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
 #include <random>
-
-/**
- * Interface class to provide the rrt algorithm with a collision detection method
- */
-class Collision_detector {
-  public:
-    /**
-     * Checks if the given state (robot configuration) is permissible (robot does not collide with walls etc)
-     *
-     * @return true if the state is permissible, false if the state is not allowed
-     */
-    virtual bool check_collision(double state[]) = 0;
-};
+#include <vector>
 
 /**
  * @brief Wrapper object for the family of rrt algorithms
@@ -24,27 +24,92 @@ class Collision_detector {
  * @tparam dimension - number of dimensions of the configuration space
  */
 template <int dimension> class RRT_solver {
+  public:
+    /** Order and density of the collision checks along the validated paths (see set_segment_validation). */
+    enum Segment_validation { FIXED_STEP, BISECTION, CONSERVATIVE_ADVANCEMENT };
+
+    /** Counters of the rewiring of the RRT* solves (see get_rewire_stats). */
+    struct Rewire_stats {
+        size_t rewires = 0;       // number of rewired vertices
+        size_t cascade_total = 0; // number of descendants whose cost was updated by the rewires
+        size_t cascade_max = 0;   // highest number of descendants updated by one rewire
+    };
+
   private:
     // for every GOAL_INSERTION_ITER iteratio the RRT algorithm tries to insert the goal state into the tree
     static constexpr int GOAL_INSERTION_ITER = 15;
+    // key of the goal state in the collision cache (goal is not a vertex of the tree until the end of the solve)
+    static constexpr uint32_t GOAL_ID = Graph<dimension>::NONE;
+    // the tree is pruned when the best goal cost drops by this fraction since the last pruning
+    static constexpr double PRUNE_IMPROVEMENT = 0.02;
+    // number of states along a path passed to Collision_detector::check_collisions at once (FIXED_STEP validation)
+    static constexpr int SEGMENT_BATCH = 8;
 
     Graph<dimension> graph;
+    Graph<dimension> goal_graph; // tree grown from the goal state by solve_rrt_connect
+    int iterations = 0;          // number of iterations made by the previous solve
     // lower and upper bounds for each of the coordinates in the configuration space - 2D array: [dimension][2]
     std::array<std::array<double, 2>, dimension> boundaries;
 
-    Collision_detector *detector;
+    const Collision_detector *detector;
+    std::unique_ptr<Collision_context> context; // scratch state for the detector queries (created by the first solve)
+
+    Collision_cache<dimension> cache; // memoized collision queries of the current solve
+    bool caching = true;
+    Segment_validation segment_validation = FIXED_STEP;
+
+    Safe_ball_cache<dimension> safe_balls; // free balls around the validated states of the current solve
+    bool safe_ball_caching = false;
+
+    Rewire_stats rewire_stats; // rewiring of the current solve
+    bool profiling = false;
+    mutable Solve_profiler profiler; // phases of the current solve (updated also by the const worker validation)
+    std::chrono::steady_clock::time_point solve_start;   // start of the current solve
+    std::chrono::steady_clock::duration first_solution; // time to the first path found by the current solve
+
+    std::unique_ptr<Thread_pool> pool; // pool for the parallel edge validation (null if disabled)
+    std::vector<std::unique_ptr<Collision_context>> worker_contexts; // detector contexts of the pool workers
+
+    Shared_bound *shared_bound = nullptr; // best goal cost shared with the solvers running in parallel (optional)
+
+    double goal_radius = 0.0;              // radius of the goal region (step of the solve if not positive)
+    double goal_region;                    // radius of the goal region of the current solve
+    std::vector<uint32_t> goal_candidates; // vertices within the goal region
+    std::vector<typename Graph<dimension>::Vertex> subtree; // stack of offer_subtree_goal_paths
+
+    bool informed = false;  // informed sampling in solve_k_rrts
+    bool pruning = false;   // pruning of the vertices which can not improve the best path (informed mode only)
+    double goal_cost;       // cost of the best path to the goal found by the current solve
+    double pruned_cost;     // goal cost for which the tree was last pruned
+    size_t pruned_vertices; // number of vertices removed by pruning in the current solve
+    uint32_t goal_parent;   // vertex from which the best path goes to the goal (valid if goal_cost is finite)
+
+    bool lazy = false; // solve_lazy_k_rrts is running (offered goal paths are validated first)
+
+    // anytime planning session (see start_anytime):
+    bool anytime = false;
+    std::array<double, dimension> session_start;
+    std::array<double, dimension> session_goal;
+    double session_step;
+    double session_delta;
+    std::list<std::array<double, dimension>> best_plan; // best plan found by the session
+    double best_plan_cost;
 
     // support for random number generation:
     std::random_device rd;
     std::mt19937 gen;
 
   public:
+    /** Callback of the anytime planning - receives new best plan and it's cost. */
+    typedef std::function<void(const std::list<std::array<double, dimension>> &plan, double cost)> Plan_callback;
+
     /**
      * @param boundaries array with 'dimension' rows and 2 columns containing lower (first) and upper (second) bounds
      * for each of the coordinates in the configuration space
-     * @param detector implementation of the Collision_detector interface
+     * @param detector implementation of the Collision_detector interface (queried through it's reentrant
+     * check_collision overload with a context owned by this solver)
      */
-    RRT_solver(const std::array<std::array<double, 2>, dimension> &boundaries, Collision_detector *detector);
+    RRT_solver(const std::array<std::array<double, 2>, dimension> &boundaries, const Collision_detector *detector);
 
     /**
      * Constructs the RRT tree and finds permissible plan
@@ -55,8 +120,27 @@ template <int dimension> class RRT_solver {
      * @param delta distance between tree nodes for which the collision is checked (lower value is better, but runs
      * slower and needs more memory)
      */
-    void solve_rrt(std::list<std::array<double, dimension>> &result_plan, std::array<double, dimension> &start_state,
-                   std::array<double, dimension> &goal_state, int iters, double delta);
+    void solve_rrt(std::list<std::array<double, dimension>> &result_plan,
+                   const std::array<double, dimension> &start_state, const std::array<double, dimension> &goal_state,
+                   int iters, double delta);
+
+    /**
+     * Finds permissible plan using the bidirectional RRT-Connect algorithm. Trees are grown from both start and goal
+     * states - in every iteration one of the trees is extended by a step towards a random state and the other tree is
+     * then greedily extended towards the new vertex until it reaches it or collides. The trees swap roles every
+     * iteration.
+     *
+     * @param result_plan reference to std::list in which the result plan is stored
+     * @param start_state starting position from which the first tree is built
+     * @param goal_state goal position from which the second tree is built
+     * @param iters maximal number of iterations of the algorithm
+     * @param step maximal distance between new and nearest vertex
+     * @param delta distance between tree nodes for which the collision is checked (lower value is better, but runs
+     * slower and needs more memory)
+     */
+    void solve_rrt_connect(std::list<std::array<double, dimension>> &result_plan,
+                           const std::array<double, dimension> &start_state,
+                           const std::array<double, dimension> &goal_state, int iters, double step, double delta);
 
     /**
      * Finds permissible plan using the k-nearest RRT* algorithm
@@ -69,8 +153,57 @@ template <int dimension> class RRT_solver {
      * @param delta distance between vertices in the result plan, for which the collision is checked (lower value is
      * better, but runs slower and needs more memory)
      */
-    void solve_k_rrts(std::list<std::array<double, dimension>> &result_plan, std::array<double, dimension> &start_state,
-                      std::array<double, dimension> &goal_state, int iters, double step, double delta);
+    void solve_k_rrts(std::list<std::array<double, dimension>> &result_plan,
+                      const std::array<double, dimension> &start_state, const std::array<double, dimension> &goal_state,
+                      int iters, double step, double delta);
+
+    /**
+     * Starts new anytime planning session with the k-nearest RRT* algorithm. The tree is cleared and then grown by the
+     * following solve_anytime calls, so the planning can be spread over multiple control cycles.
+     *
+     * @param start_state starting position from which the RRT tree is built
+     * @param goal_state goal position to which we need to find path to
+     * @param step step size of the algorithm - distance between new and nearest vertex (vertices within step distance
+     * from the goal are connected to it)
+     * @param delta distance between vertices in the result plan, for which the collision is checked
+     */
+    void start_anytime(const std::array<double, dimension> &start_state,
+                       const std::array<double, dimension> &goal_state, double step, double delta);
+
+    /**
+     * Continues growing the tree of the session started by start_anytime until the deadline passes or the cancel flag
+     * is set.
+     *
+     * @param result_plan reference to std::list in which the best plan found by the session so far is stored (empty if
+     * no plan was found yet)
+     * @param deadline point in time at which the method returns (it finishes the current iteration first)
+     * @param cancel optional flag checked every iteration (it can be set from another thread)
+     * @param on_improvement optional callback called every time the best plan improves (by a new path to the goal or
+     * by a rewire shortening the path to the last vertex of the best plan)
+     * @return true if the session found some plan
+     */
+    bool solve_anytime(std::list<std::array<double, dimension>> &result_plan,
+                       std::chrono::steady_clock::time_point deadline, const std::atomic<bool> *cancel = nullptr,
+                       const Plan_callback &on_improvement = nullptr);
+
+    /**
+     * Same as the solve_anytime above with the deadline given as a time budget from now.
+     */
+    bool solve_anytime(std::list<std::array<double, dimension>> &result_plan,
+                       std::chrono::steady_clock::duration budget, const std::atomic<bool> *cancel = nullptr,
+                       const Plan_callback &on_improvement = nullptr);
+
+    /**
+     * Finds permissible plan using the lazy variant of the k-nearest RRT* algorithm. The tree is built optimistically -
+     * only the new states are checked for collisions, edges are not validated. Edges are validated only when they end
+     * up on a path to the goal region (see set_goal_radius) cheaper than the best valid path found so far - colliding
+     * edges are replaced or their subtree is cut off (see get_goal_cost). After the last iteration the cheapest path
+     * to the goal is validated and repaired the same way until a valid path is found. Parameters are the same as for
+     * solve_k_rrts.
+     */
+    void solve_lazy_k_rrts(std::list<std::array<double, dimension>> &result_plan,
+                           const std::array<double, dimension> &start_state,
+                           const std::array<double, dimension> &goal_state, int iters, double step, double delta);
 
     /**
      * Returns the result tree
@@ -80,25 +213,251 @@ template <int dimension> class RRT_solver {
      */
     Graph<dimension> &get_tree();
 
+    /**
+     * Returns the tree grown from the goal state by the previous solve_rrt_connect call (the tree from the start state
+     * is returned by get_tree).
+     */
+    Graph<dimension> &get_goal_tree();
+
+    /**
+     * Returns the number of iterations made by the previous "solve" call (solve_rrt and solve_rrt_connect stop as soon
+     * as the path is found).
+     */
+    int get_iterations() const;
+
+    /**
+     * Returns the time from the start of the previous "solve" call to the first path to the goal it found
+     * (duration::max() if no path was found). solve_rrt and solve_rrt_connect stop at the first path, solve_k_rrts
+     * finds it when the first vertex of the goal region is connected to the goal and solve_lazy_k_rrts only after the
+     * last iteration.
+     */
+    std::chrono::steady_clock::duration get_first_solution_time() const;
+
+    /**
+     * Enables or disables memoization of the collision queries (enabled by default). The cache is cleared at the start
+     * of every solve.
+     */
+    void set_caching(bool enabled);
+
+    /**
+     * Returns hit and miss counters of the collision cache for the previous "solve" call
+     */
+    const typename Collision_cache<dimension>::Stats &get_cache_stats() const;
+
+    /**
+     * Returns the rewiring counters of the previous "solve" call. Every rewire updates the costs of the whole subtree
+     * of the rewired vertex, the cascade counters show how many descendants it costs.
+     */
+    const Rewire_stats &get_rewire_stats() const;
+
+    /**
+     * Enables or disables the profiling of the solves (disabled by default). The profiler counts the operations of the
+     * phases of the solve and measures their cumulative time. Disabled profiling doesn't read the clock nor update any
+     * counters.
+     */
+    void set_profiling(bool enabled);
+
+    /**
+     * Returns the counters and times of the phases of the previous "solve" call (or of the anytime session so far) -
+     * all zeros if the profiling was disabled.
+     */
+    Solve_report get_solve_report() const;
+
+    /**
+     * Enables or disables the safe ball cache (disabled by default). Every random state and end state of a path found
+     * permissible is cached together with the radius of the free ball around it (see
+     * Collision_detector::get_free_radius) and states inside of the cached balls are not passed to the detector. The
+     * cache is cleared at the start of every solve. Pays off only if the detector's free radius query is cheap compared
+     * to the collision checks it saves (the parallel edge validation doesn't use the cache).
+     */
+    void set_safe_ball_caching(bool enabled);
+
+    /**
+     * Returns hit and miss counters of the safe ball cache for the previous "solve" call
+     */
+    const typename Safe_ball_cache<dimension>::Stats &get_safe_ball_stats() const;
+
+    /**
+     * Sets how the states along the paths are checked (FIXED_STEP by default). All modes check (a subset of) the states
+     * in the delta distance along the path, so they accept the same paths for a conservative detector:
+     * - FIXED_STEP checks the states in order from the start of the path (in batches of SEGMENT_BATCH states through
+     *   Collision_detector::check_collisions)
+     * - BISECTION checks the middle state first and then recursively the middles of both halves, so collisions in the
+     *   middle of long paths are found early (paths extended by solve_rrt are still checked from the start, because
+     *   their collision free prefix is used)
+     * - CONSERVATIVE_ADVANCEMENT checks the states in order, but skips all states inside of the free ball around the
+     *   checked state reported by Collision_detector::get_free_radius (only the states in the delta distance are
+     *   checked near the obstacles or if the detector doesn't report the radius)
+     */
+    void set_segment_validation(Segment_validation mode);
+
+    /**
+     * Sets the number of threads used to validate edges in solve_k_rrts (1 - the default - disables the parallel
+     * validation). In every iteration all candidate edges for the parent choice and the rewiring are validated at once
+     * on a work stealing thread pool, results are then applied serially in the same order as in the serial version, so
+     * the resulting tree does not depend on the number of threads. The detector must support reentrant queries.
+     */
+    void set_threads(size_t threads);
+
+    /**
+     * Reseeds the random number generator (solvers are seeded with the same constant by default, so the results are
+     * reproducible).
+     */
+    void set_seed(unsigned seed);
+
+    /**
+     * Shares the cost of the best path with other solvers (nullptr to disable - the default). With the bound set
+     * solve_rrt stops as soon as any of the solvers finds a path and solve_k_rrts publishes the costs of the paths it
+     * finds during the solve and skips random states which can not improve the shared best path (skipped states count
+     * as iterations, colliding states are resampled). Used by Parallel_RRT_solver.
+     */
+    void set_shared_bound(Shared_bound *bound);
+
+    /**
+     * Enables informed sampling in solve_k_rrts (disabled by default). Once a path to the goal is found, random states
+     * are drawn only from the prolate hyperspheroid with foci in the start and goal states containing all states which
+     * can lie on a shorter path (see get_goal_cost).
+     *
+     * @param pruning if true, vertices whose cost plus the distance to the goal exceeds the best goal cost (they can
+     * not be part of a better path) are removed from the tree every time the best cost improves by PRUNE_IMPROVEMENT
+     */
+    void set_informed_sampling(bool enabled, bool pruning = false);
+
+    /**
+     * Sets the radius of the goal region used by solve_k_rrts and the anytime planning (the step of the solve by
+     * default). Vertices within the goal region are tracked as they are added to the tree and the goal is connected
+     * only to them (no plan is found if none of them can be connected).
+     */
+    void set_goal_radius(double radius);
+
+    /**
+     * Returns the cost of the best path to the goal found by the current (or previous) k-nearest RRT* solve so far
+     * (infinity if no path was found yet). The cost is updated every time a vertex in the goal region is added or the
+     * path to it is shortened by a rewire (of the vertex or of any of it's ancestors).
+     */
+    double get_goal_cost() const;
+
+    /**
+     * Returns the number of vertices removed by pruning during the previous solve_k_rrts call.
+     */
+    size_t get_pruned_vertices() const;
+
   private:
+    /** Clears the tree and the caches of the previous solve and adds the start state as the root of the tree. */
+    void start_solve(const std::array<double, dimension> &start_state);
+    /** One iteration of the k-nearest RRT* algorithm - adds (at most) one vertex to the tree and rewires it's
+     * neighbours. */
+    void k_rrts_iteration(const std::array<double, dimension> &start_state,
+                          const std::array<double, dimension> &goal_state, double step, double delta);
     std::array<double, dimension> get_random_state();
     std::array<double, dimension> get_random_free_state();
     /** Finds all free configurations between start and stop by by moving an incremental distance delta. Returns true if
      * even the goal state is collision free (is also added to the new_states vector).*/
-    bool get_free_states(std::vector<std::array<double, dimension>> &new_states, std::array<double, dimension> &start,
-                         std::array<double, dimension> &stop, double delta);
+    bool get_free_states(std::vector<std::array<double, dimension>> &new_states,
+                         const std::array<double, dimension> &start, const std::array<double, dimension> &stop,
+                         double delta);
     /** Checks if the straight path from start to stop is collision free by moving an incremental distance delta (works
      * in the same way as get_free_states but doesn't return any new states)  */
-    bool is_collision_free(std::array<double, dimension> &start, std::array<double, dimension> &stop, double delta);
+    bool is_collision_free(const std::array<double, dimension> &start, const std::array<double, dimension> &stop,
+                           double delta);
+    /** Cached version of is_collision_free for the straight path between two vertices given by their ids (the path is
+     * treated as undirected - it is validated only once for both directions). */
+    bool is_collision_free(uint32_t start_id, const std::array<double, dimension> &start, uint32_t stop_id,
+                           const std::array<double, dimension> &stop, double delta);
+    /** Thread safe version of is_collision_free used by the pool workers (does not use the cache). */
+    bool is_collision_free(const std::array<double, dimension> &start, const std::array<double, dimension> &stop,
+                           double delta, Collision_context &worker_context) const;
+    /** Checks the states start + i * delta * direction for i in [1, count] (direction is normalized) in the order
+     * given by the segment validation mode. States inside of the balls (optional) are not checked. Returns false on
+     * the first colliding state. */
+    bool check_segment(const std::array<double, dimension> &start, const std::array<double, dimension> &direction,
+                       int count, double delta, Collision_context &query_context,
+                       Safe_ball_cache<dimension> *balls) const;
+    /** Validates (in parallel) the edges between the k nearest neighbours and the new state which are needed by the
+     * current iteration of solve_k_rrts - parent candidates cheaper than min_cost and the rewiring candidates. Results
+     * are stored to the edges array (1 free, 0 colliding, -1 not validated). */
+    void validate_edges(std::vector<signed char> &edges,
+                        const std::vector<typename Graph<dimension>::Vertex> &k_nearest, double min_cost,
+                        uint32_t new_id, const std::array<double, dimension> &new_state, double delta);
+    /** Validates the edges from the neighbours given by the batch indices to the new state on the thread pool. */
+    void validate_batch(std::vector<signed char> &edges,
+                        const std::vector<typename Graph<dimension>::Vertex> &k_nearest, std::vector<size_t> &batch,
+                        uint32_t new_id, const std::array<double, dimension> &new_state, double delta);
+    /** Returns uniformly distributed random state from the prolate hyperspheroid of the states whose straight line
+     * distance from the start plus the distance to the goal is lower than best_cost (only states inside the
+     * boundaries are returned). */
+    std::array<double, dimension> get_informed_state(const std::array<double, dimension> &start_state,
+                                                     const std::array<double, dimension> &goal_state,
+                                                     double best_cost);
+    /** Returns the lower of the best goal cost of this solve and the shared best cost. */
+    double get_best_cost() const;
+    /** Returns true if the shortest possible path from the start through the state to the goal is not better than the
+     * best path found so far. */
+    bool is_pruned(const std::array<double, dimension> &state, const std::array<double, dimension> &start_state,
+                   const std::array<double, dimension> &goal_state) const;
+    /** Records (and publishes to the shared bound) the cost of the path through the vertex to the goal, if the vertex
+     * is in the goal region, the path is better than the best path and it's last edge is collision free (the cost of
+     * the best path is updated if the vertex is it's last vertex). */
+    void offer_goal_path(Graph<dimension>::Vertex vertex, const std::array<double, dimension> &goal_state,
+                         double delta);
+    /** Lazy variant of offer_goal_path - the whole path to the vertex is validated (and the tree is repaired if some of
+     * it's edges collide) before it's recorded as the best path. */
+    void offer_lazy_goal_path(Graph<dimension>::Vertex vertex, const std::array<double, dimension> &goal_state,
+                              double delta);
+    /** Offers the paths through the vertex and all of it's descendants (their costs dropped with the rewired vertex, so
+     * the best path can now go through any of them). Uses offer_lazy_goal_path in the lazy solve. */
+    void offer_subtree_goal_paths(Graph<dimension>::Vertex vertex, const std::array<double, dimension> &goal_state,
+                                  double delta);
+    /** Calls the collision detector for the state (or returns the cached result of the previous call). Used for the
+     * random states and the end states of the paths which are queried repeatedly - intermediate states along the paths
+     * almost never repeat, so they are passed to the detector directly. */
+    bool check_state(const std::array<double, dimension> &state);
     /**  Returns state in the step_size distance from start in the given direction. If distance from start to direction
-     * state is lower than step_size, then direction is returned.*/
-    std::array<double, dimension> move_a_step(std::array<double, dimension> &start,
-                                              std::array<double, dimension> &direction, double step_size, double delta);
+     * state is lower than step_size, then direction is returned. Sets reachable to true if the path from start to the
+     * returned state was validated.*/
+    std::array<double, dimension> move_a_step(const std::array<double, dimension> &start,
+                                              const std::array<double, dimension> &direction, double step_size,
+                                              double delta, bool &reachable);
+    /** Extends the tree from it's vertex nearest to the target by (at most) step towards the target. Returns the new
+     * vertex (or an empty handle if no free state was found) and sets reached to true if the new vertex is the
+     * target. */
+    Graph<dimension>::Vertex extend(Graph<dimension> &tree, const std::array<double, dimension> &target, double step,
+                                    double delta, bool &reached);
+    /** Returns state in the step_size distance from start in the given direction (or direction if it is closer). No
+     * collisions are checked. */
+    std::array<double, dimension> steer(const std::array<double, dimension> &start,
+                                        const std::array<double, dimension> &direction, double step_size);
+    /** Validates the edges on the path from the root to the vertex (starting from the root). Returns the child vertex
+     * of the first colliding edge or an empty handle if the whole path is collision free. */
+    Graph<dimension>::Vertex validate_path(Graph<dimension>::Vertex vertex, double delta);
+    /** Returns the profiler phase if the profiling is enabled (null otherwise - see Solve_profiler::Timer). */
+    Solve_profiler::Phase *profile(Solve_profiler::Phase &phase) const;
+    /** Profiled queries of the trees and of the detector (all queries of the solves go through them). */
+    Graph<dimension>::Vertex get_nearest(const Graph<dimension> &tree,
+                                         const std::array<double, dimension> &state) const;
+    void get_k_nearest(Graph<dimension> &tree, std::vector<typename Graph<dimension>::Vertex> &k_nearest,
+                       const std::array<double, dimension> &state, size_t k) const;
+    Graph<dimension>::Vertex insert_vertex(Graph<dimension> &tree, const std::array<double, dimension> &state,
+                                           Graph<dimension>::Vertex parent, double weight) const;
+    bool query_detector(const std::array<double, dimension> &state, Collision_context &query_context) const;
+    /** Records the time of the first path to the goal found by the current solve (later calls are ignored). */
+    void record_solution();
+    /** Rewires the vertex to the new parent (updating the costs of it's subtree) and counts the rewire. Returns the
+     * number of the updated descendants. */
+    size_t rewire(Graph<dimension>::Vertex vertex, Graph<dimension>::Vertex new_parent, double weight);
+    /** Cuts off the vertex whose edge from the parent collides and lazily reconnects the vertices of it's subtree to
+     * the cheapest neighbours which are still connected to the root. Vertices which can not be reconnected are left
+     * detached from the tree (with infinite cost). */
+    void repair_vertex(Graph<dimension>::Vertex vertex);
     void construct_result_plan(std::list<std::array<double, dimension>> &result_plan,
-                               Graph<dimension>::Vertex *goal_vertex);
+                               Graph<dimension>::Vertex goal_vertex);
     /** Constructs result plan, but also splits all edges so the disance between vertices is delta at maximum */
     void construct_result_plan(std::list<std::array<double, dimension>> &result_plan,
-                               Graph<dimension>::Vertex *goal_vertex, double delta);
+                               Graph<dimension>::Vertex goal_vertex, double delta);
+    /** Appends the states splitting the validated edge from start to stop (excluding start) to the plan. The states
+     * depend on the direction of the split, so the edge is split from the stop if it was validated from it. */
+    void append_edge(std::list<std::array<double, dimension>> &result_plan, const std::array<double, dimension> &start,
+                     const std::array<double, dimension> &stop, double delta);
 };
 
 #include "rrt.tpp"
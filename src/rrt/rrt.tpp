@@ -1,24 +1,34 @@
 #pragma once
 
 #include "rrt.hpp"
+#include <algorithm>
 #include <array>
 #include <array_math.hpp>
+#include <bit>
+#include <iterator>
 #include <limits>
+#include <queue>
 
 template <int dimension>
 RRT_solver<dimension>::RRT_solver(const std::array<std::array<double, 2>, dimension> &boundaries,
-                                  Collision_detector *detector)
+                                  const Collision_detector *detector)
     : boundaries(boundaries), detector(detector), gen(/*rd()*/ 42){};
 
 template <int dimension>
 void RRT_solver<dimension>::solve_rrt(std::list<std::array<double, dimension>> &result_plan,
-                                      std::array<double, dimension> &start_state,
-                                      std::array<double, dimension> &goal_state, int iters, double delta) {
-    graph.clear();
-    graph.add_vertex(start_state);
+                                      const std::array<double, dimension> &start_state,
+                                      const std::array<double, dimension> &goal_state, int iters, double delta) {
+    Solve_profiler::Timer timer(profile(profiler.solve));
+    Trace_scope trace("solve_rrt", "rrt");
+    start_solve(start_state);
     bool quit = false;
 
     for (int i = 0; !quit && i < iters; i++) {
+        Trace_scope iteration_trace("iteration", "rrt");
+        iterations++;
+        if (shared_bound && shared_bound->is_solved()) { // other solver was faster
+            break;
+        }
 
         std::array<double, dimension> random_state;
         if ((i % GOAL_INSERTION_ITER) == 0) {
@@ -28,10 +38,10 @@ void RRT_solver<dimension>::solve_rrt(std::list<std::array<double, dimension>> &
             random_state = get_random_state();
         }
 
-        auto nearest_vertex = graph.get_nearest(random_state);
+        auto nearest_vertex = get_nearest(graph, random_state);
 
         std::vector<std::array<double, dimension>> new_states;
-        bool path_is_collision_free = get_free_states(new_states, nearest_vertex->coords, random_state, delta);
+        bool path_is_collision_free = get_free_states(new_states, nearest_vertex.coords(), random_state, delta);
 
         if (((i % GOAL_INSERTION_ITER) == 0) && path_is_collision_free) { // adding goal state and path to it is free
             quit = true; // goal state reached -> quitting in the next iter
@@ -40,72 +50,402 @@ void RRT_solver<dimension>::solve_rrt(std::list<std::array<double, dimension>> &
         // adding new states to the graph:
         for (auto &new_state : new_states) {
             auto new_vertex =
-                graph.connect_new_vertex(new_state, nearest_vertex, vector_distance(nearest_vertex->coords, new_state));
+                insert_vertex(graph, new_state, nearest_vertex, vector_distance(nearest_vertex.coords(), new_state));
             nearest_vertex = new_vertex;
         }
     }
 
     if (quit) { // found path to goal
+        record_solution();
+        if (shared_bound) {
+            shared_bound->offer(graph.get_last().cost());
+        }
         construct_result_plan(result_plan, graph.get_last());
     } else {
         result_plan.clear();
     }
 }
 
+template <int dimension>
+void RRT_solver<dimension>::solve_rrt_connect(std::list<std::array<double, dimension>> &result_plan,
+                                              const std::array<double, dimension> &start_state,
+                                              const std::array<double, dimension> &goal_state, int iters, double step,
+                                              double delta) {
+    Solve_profiler::Timer timer(profile(profiler.solve));
+    Trace_scope trace("solve_rrt_connect", "rrt");
+    start_solve(start_state);
+    goal_graph.clear();
+    goal_graph.add_vertex(goal_state);
+
+    Graph<dimension> *tree_a = &graph;      // tree extended towards the random state
+    Graph<dimension> *tree_b = &goal_graph; // tree connected to the new vertex of tree_a
+    typename Graph<dimension>::Vertex start_side, goal_side; // vertices in which the trees met
+
+    for (int i = 0; !start_side && i < iters; i++) {
+        Trace_scope iteration_trace("iteration", "rrt");
+        iterations++;
+        std::array<double, dimension> random_state = get_random_free_state();
+
+        bool reached;
+        auto new_vertex = extend(*tree_a, random_state, step, delta, reached);
+        if (new_vertex) {
+            // greedily connecting the other tree to the new vertex:
+            typename Graph<dimension>::Vertex connect_vertex;
+            do {
+                connect_vertex = extend(*tree_b, new_vertex.coords(), step, delta, reached);
+            } while (connect_vertex && !reached);
+
+            if (reached) {
+                start_side = tree_a == &graph ? new_vertex : connect_vertex;
+                goal_side = tree_a == &graph ? connect_vertex : new_vertex;
+            }
+        }
+        std::swap(tree_a, tree_b);
+    }
+
+    result_plan.clear();
+    if (start_side) {
+        record_solution();
+        // edges are split in the same direction in which they were validated (from the parent to the child):
+        std::list<std::array<double, dimension>> vertices;
+        construct_result_plan(vertices, start_side);
+        result_plan.push_back(vertices.front());
+        std::vector<std::array<double, dimension>> new_states;
+        for (auto it = std::next(vertices.begin()); it != vertices.end(); it++) {
+            new_states.clear();
+            get_free_states(new_states, *std::prev(it), *it, delta);
+            result_plan.insert(result_plan.end(), new_states.begin(), new_states.end());
+        }
+
+        // path from the vertex in which the trees met to the goal goes from the children to the parents:
+        for (auto current = goal_side; current.parent(); current = current.parent()) {
+            new_states.clear();
+            get_free_states(new_states, current.parent().coords(), current.coords(), delta);
+            if (!new_states.empty() && new_states.back() == current.coords()) {
+                new_states.pop_back(); // current vertex is already in the plan
+            }
+            result_plan.insert(result_plan.end(), new_states.rbegin(), new_states.rend());
+            result_plan.push_back(current.parent().coords());
+        }
+    }
+}
+
 template <int dimension>
 void RRT_solver<dimension>::solve_k_rrts(std::list<std::array<double, dimension>> &result_plan,
-                                         std::array<double, dimension> &start_state,
-                                         std::array<double, dimension> &goal_state, int iters, double step,
+                                         const std::array<double, dimension> &start_state,
+                                         const std::array<double, dimension> &goal_state, int iters, double step,
                                          double delta) {
-    graph.clear();
-    graph.add_vertex(start_state);
+    Solve_profiler::Timer timer(profile(profiler.solve));
+    Trace_scope trace("solve_k_rrts", "rrt");
+    start_solve(start_state);
+    goal_region = goal_radius > 0.0 ? goal_radius : step;
 
     for (int i = 0; i < iters; i++) {
-        std::array<double, dimension> random_state = get_random_free_state();
-        auto nearest = graph.get_nearest(random_state);
-        std::array<double, dimension> new_state = move_a_step(nearest->coords, random_state, step, delta);
-
-        if (is_collision_free(nearest->coords, new_state, delta)) {
-            int k = (int)(2 * M_E * std::log(graph.size())); // number of nearest neighbours
-            std::vector<typename Graph<dimension>::Vertex *> k_nearest;
-            graph.get_k_nearest(k_nearest, new_state, k);
-
-            auto min_state = nearest;
-            double min_cost = nearest->cost + vector_distance(nearest->coords, new_state);
-            for (auto neighbour : k_nearest) { // connectiong new vertex along minimum cost path
-                if (is_collision_free(neighbour->coords, new_state, delta) &&
-                    (neighbour->cost + vector_distance(neighbour->coords, new_state) < min_cost)) {
-                    min_state = neighbour;
-                    min_cost = neighbour->cost + vector_distance(neighbour->coords, new_state);
+        k_rrts_iteration(start_state, goal_state, step, delta);
+    }
+
+    // connecting the goal to the cheapest vertex from the goal region (candidates are validated in the order of the
+    // cost of the path through them, so the first free one is the best):
+    std::vector<std::pair<double, uint32_t>> candidates;
+    for (uint32_t id : goal_candidates) {
+        auto vertex = graph.get_vertex(id);
+        candidates.push_back({vertex.cost() + vector_distance(vertex.coords(), goal_state), id});
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    typename Graph<dimension>::Vertex min_vertex;
+    for (const std::pair<double, uint32_t> &candidate : candidates) {
+        auto vertex = graph.get_vertex(candidate.second);
+        if (is_collision_free(vertex.id(), vertex.coords(), GOAL_ID, goal_state, delta)) {
+            min_vertex = vertex;
+            break;
+        }
+    }
+
+    if (min_vertex) {
+        record_solution();
+        auto goal_vertex =
+            insert_vertex(graph, goal_state, min_vertex, vector_distance(min_vertex.coords(), goal_state));
+        if (shared_bound) {
+            shared_bound->offer(goal_vertex.cost());
+        }
+        construct_result_plan(result_plan, goal_vertex, delta);
+    } else {
+        result_plan.clear();
+    }
+}
+
+template <int dimension>
+void RRT_solver<dimension>::start_anytime(const std::array<double, dimension> &start_state,
+                                          const std::array<double, dimension> &goal_state, double step,
+                                          double delta) {
+    start_solve(start_state);
+    goal_region = goal_radius > 0.0 ? goal_radius : step;
+    anytime = true;
+    session_start = start_state;
+    session_goal = goal_state;
+    session_step = step;
+    session_delta = delta;
+    best_plan.clear();
+    best_plan_cost = std::numeric_limits<double>::infinity();
+}
+
+template <int dimension>
+bool RRT_solver<dimension>::solve_anytime(std::list<std::array<double, dimension>> &result_plan,
+                                          std::chrono::steady_clock::time_point deadline,
+                                          const std::atomic<bool> *cancel, const Plan_callback &on_improvement) {
+    Solve_profiler::Timer timer(profile(profiler.solve));
+    Trace_scope trace("solve_anytime", "rrt");
+    while (std::chrono::steady_clock::now() < deadline && !(cancel && cancel->load(std::memory_order_relaxed))) {
+        k_rrts_iteration(session_start, session_goal, session_step, session_delta);
+        if (goal_cost == std::numeric_limits<double>::infinity()) {
+            continue;
+        }
+
+        // cost of the plan through the goal parent is taken from the tree (costs of the vertices are exact - rewires
+        // update the costs of the whole subtrees), so it matches the length of the plan built from the tree path:
+        auto parent = graph.get_vertex(goal_parent);
+        double cost = parent.cost() + vector_distance(parent.coords(), session_goal);
+        if (cost < best_plan_cost) {
+            best_plan_cost = cost;
+            best_plan.clear();
+            std::list<std::array<double, dimension>> vertices;
+            construct_result_plan(vertices, parent);
+            vertices.push_back(session_goal);
+            best_plan.push_back(vertices.front());
+            for (auto it = std::next(vertices.begin()); it != vertices.end(); it++) {
+                append_edge(best_plan, *std::prev(it), *it, session_delta);
+            }
+
+            if (on_improvement) {
+                on_improvement(best_plan, best_plan_cost);
+            }
+        }
+    }
+
+    result_plan = best_plan;
+    return !best_plan.empty();
+}
+
+template <int dimension>
+bool RRT_solver<dimension>::solve_anytime(std::list<std::array<double, dimension>> &result_plan,
+                                          std::chrono::steady_clock::duration budget,
+                                          const std::atomic<bool> *cancel, const Plan_callback &on_improvement) {
+    return solve_anytime(result_plan, std::chrono::steady_clock::now() + budget, cancel, on_improvement);
+}
+
+template <int dimension>
+void RRT_solver<dimension>::k_rrts_iteration(const std::array<double, dimension> &start_state,
+                                             const std::array<double, dimension> &goal_state, double step,
+                                             double delta) {
+    Trace_scope trace("iteration", "rrt");
+    iterations++;
+    std::array<double, dimension> random_state;
+    if (shared_bound || informed) {
+        double best_cost = get_best_cost();
+        if (pruning && best_cost < pruned_cost * (1.0 - PRUNE_IMPROVEMENT)) {
+            // relative tolerance keeps the vertices on the best path despite rounding errors in their costs
+            std::vector<uint32_t> new_ids;
+            pruned_vertices += graph.prune(
+                [&](typename Graph<dimension>::Vertex vertex) {
+                    return vertex.cost() + vector_distance(vertex.coords(), goal_state) <= best_cost * (1.0 + 1e-9);
+                },
+                &new_ids);
+            cache.clear_segments(); // vertex ids were changed
+            pruned_cost = best_cost;
+
+            if (goal_cost < std::numeric_limits<double>::infinity()) {
+                goal_parent = new_ids[goal_parent];
+                if (goal_parent == Graph<dimension>::NONE) { // path of other solver's bound is shorter than this one
+                    goal_cost = std::numeric_limits<double>::infinity();
                 }
             }
 
-            auto new_vertex =
-                graph.connect_new_vertex(new_state, min_state, vector_distance(min_state->coords, new_state));
+            goal_candidates.clear();
+            for (uint32_t id = 0; id < graph.size(); id++) {
+                if (vector_distance_sq(graph.get_vertex(id).coords(), goal_state) <= goal_region * goal_region) {
+                    goal_candidates.push_back(id);
+                }
+            }
+        }
 
-            for (auto neighbour : k_nearest) { // rewiring the tree
-                if (is_collision_free(new_vertex->coords, neighbour->coords, delta) &&
-                    ((new_vertex->cost + vector_distance(new_vertex->coords, neighbour->coords)) < neighbour->cost)) {
-                    graph.rewire_vertex(neighbour, new_vertex, vector_distance(new_vertex->coords, neighbour->coords));
+        // colliding states are resampled, states which can't improve the best path count as iterations:
+        while (true) {
+            if (informed && best_cost < std::numeric_limits<double>::infinity()) {
+                random_state = get_informed_state(start_state, goal_state, best_cost);
+            } else {
+                random_state = get_random_state();
+            }
+            if (is_pruned(random_state, start_state, goal_state)) {
+                return;
+            }
+            if (check_state(random_state)) {
+                break;
+            }
+            if (profiling) {
+                profiler.rejected_samples++;
+            }
+        }
+    } else {
+        random_state = get_random_free_state();
+    }
+    auto nearest = get_nearest(graph, random_state);
+    bool reachable;
+    std::array<double, dimension> new_state = move_a_step(nearest.coords(), random_state, step, delta, reachable);
+
+    if (reachable) {
+        // id which the new vertex will get once it is added to the graph (used as a key to the collision cache)
+        uint32_t new_id = (uint32_t)graph.size();
+        if (caching) {
+            cache.store_segment(nearest.id(), new_id, true); // path was already validated by move_a_step
+        }
+
+        int k = (int)(2 * M_E * std::log(graph.size())); // number of nearest neighbours
+        std::vector<typename Graph<dimension>::Vertex> k_nearest;
+        get_k_nearest(graph, k_nearest, new_state, k);
+
+        auto min_state = nearest;
+        double min_cost = nearest.cost() + vector_distance(nearest.coords(), new_state);
+
+        // validity of the edges between the neighbours and the new state (-1 if not validated yet)
+        std::vector<signed char> edges(k_nearest.size(), -1);
+        if (pool) {
+            validate_edges(edges, k_nearest, min_cost, new_id, new_state, delta);
+        }
+        auto is_edge_free = [&](size_t j) {
+            if (edges[j] < 0) {
+                edges[j] = is_collision_free(k_nearest[j].id(), k_nearest[j].coords(), new_id, new_state, delta);
+            }
+            return edges[j] == 1;
+        };
+
+        for (size_t j = 0; j < k_nearest.size(); j++) { // connectiong new vertex along minimum cost path
+            double cost = k_nearest[j].cost() + vector_distance(k_nearest[j].coords(), new_state);
+            if (cost < min_cost && is_edge_free(j)) {
+                min_state = k_nearest[j];
+                min_cost = cost;
+            }
+        }
+
+        auto new_vertex =
+            insert_vertex(graph, new_state, min_state, vector_distance(min_state.coords(), new_state));
+
+        for (size_t j = 0; j < k_nearest.size(); j++) { // rewiring the tree
+            auto neighbour = k_nearest[j];
+            double weight = vector_distance(new_vertex.coords(), neighbour.coords());
+            if (((new_vertex.cost() + weight) < neighbour.cost()) && is_edge_free(j)) {
+                if (rewire(neighbour, new_vertex, weight) > 0) { // paths through the descendants got cheaper too
+                    offer_subtree_goal_paths(neighbour, goal_state, delta);
+                } else {
+                    offer_goal_path(neighbour, goal_state, delta);
                 }
             }
         }
+
+        if (vector_distance_sq(new_vertex.coords(), goal_state) <= goal_region * goal_region) {
+            goal_candidates.push_back(new_vertex.id());
+        }
+        offer_goal_path(new_vertex, goal_state, delta);
     }
+}
 
-    // try adding goal vertex at the end:
-    typename Graph<dimension>::Vertex *min_vertex = nullptr;
-    double min_cost = std::numeric_limits<double>::max();
-    for (auto vertex : graph.vertices) {
-        if (is_collision_free(vertex->coords, goal_state, delta) &&
-            (vertex->cost + vector_distance(vertex->coords, goal_state) < min_cost)) {
-            min_vertex = vertex;
-            min_cost = vertex->cost + vector_distance(vertex->coords, goal_state);
+template <int dimension>
+void RRT_solver<dimension>::solve_lazy_k_rrts(std::list<std::array<double, dimension>> &result_plan,
+                                              const std::array<double, dimension> &start_state,
+                                              const std::array<double, dimension> &goal_state, int iters, double step,
+                                              double delta) {
+    Solve_profiler::Timer timer(profile(profiler.solve));
+    Trace_scope trace("solve_lazy_k_rrts", "rrt");
+    start_solve(start_state);
+    goal_region = goal_radius > 0.0 ? goal_radius : step;
+    lazy = true;
+
+    // the lazy algorithm relies on the cache to remember the colliding edges
+    bool caching_enabled = caching;
+    caching = true;
+
+    for (int i = 0; i < iters; i++) {
+        Trace_scope iteration_trace("iteration", "rrt");
+        iterations++;
+        std::array<double, dimension> random_state = get_random_free_state();
+        auto nearest = get_nearest(graph, random_state);
+        std::array<double, dimension> new_state = steer(nearest.coords(), random_state, step);
+        if (!check_state(new_state)) {
+            continue;
+        }
+
+        int k = (int)(2 * M_E * std::log(graph.size())); // number of nearest neighbours
+        std::vector<typename Graph<dimension>::Vertex> k_nearest;
+        get_k_nearest(graph, k_nearest, new_state, k);
+
+        auto min_state = nearest;
+        double min_cost = nearest.cost() + vector_distance(nearest.coords(), new_state);
+        for (auto neighbour : k_nearest) { // connecting new vertex along minimum cost path (edges are not validated)
+            double cost = neighbour.cost() + vector_distance(neighbour.coords(), new_state);
+            if (cost < min_cost) {
+                min_state = neighbour;
+                min_cost = cost;
+            }
+        }
+
+        auto new_vertex =
+            insert_vertex(graph, new_state, min_state, vector_distance(min_state.coords(), new_state));
+
+        for (auto neighbour : k_nearest) { // rewiring the tree (edges are not validated)
+            double weight = vector_distance(new_vertex.coords(), neighbour.coords());
+            if ((new_vertex.cost() + weight) < neighbour.cost()) {
+                if (rewire(neighbour, new_vertex, weight) > 0) {
+                    offer_subtree_goal_paths(neighbour, goal_state, delta);
+                } else {
+                    offer_lazy_goal_path(neighbour, goal_state, delta);
+                }
+            }
         }
+        offer_lazy_goal_path(new_vertex, goal_state, delta);
     }
+    lazy = false;
 
-    if (min_vertex != nullptr) {
+    // candidates for the goal connection ordered by the (cost to vertex + distance to goal) bound
+    typedef std::pair<double, uint32_t> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    for (uint32_t id = 0; id < graph.size(); id++) {
+        auto vertex = graph.get_vertex(id);
+        candidates.push({vertex.cost() + vector_distance(vertex.coords(), goal_state), id});
+    }
+
+    // (the best path found during the growth is on the top of the queue and it's edges are cached as free)
+    typename Graph<dimension>::Vertex goal_parent;
+    while (!goal_parent && !candidates.empty()) {
+        auto [bound, id] = candidates.top();
+        candidates.pop();
+        auto vertex = graph.get_vertex(id);
+        double cost = vertex.cost() + vector_distance(vertex.coords(), goal_state);
+        if (cost == std::numeric_limits<double>::infinity()) {
+            continue; // vertex was cut off from the tree
+        }
+        if (cost > bound) {
+            candidates.push({cost, id}); // path to the vertex got more expensive after the repairs
+            continue;
+        }
+        if (!is_collision_free(id, vertex.coords(), GOAL_ID, goal_state, delta)) {
+            continue;
+        }
+
+        auto colliding = validate_path(vertex, delta);
+        if (colliding) {
+            repair_vertex(colliding);
+            candidates.push({vertex.cost() + vector_distance(vertex.coords(), goal_state), id});
+        } else {
+            goal_parent = vertex;
+        }
+    }
+    caching = caching_enabled;
+
+    if (goal_parent) {
+        record_solution();
         auto goal_vertex =
-            graph.connect_new_vertex(goal_state, min_vertex, vector_distance(min_vertex->coords, goal_state));
+            insert_vertex(graph, goal_state, goal_parent, vector_distance(goal_parent.coords(), goal_state));
+        goal_cost = goal_vertex.cost();
         construct_result_plan(result_plan, goal_vertex, delta);
     } else {
         result_plan.clear();
@@ -114,7 +454,95 @@ void RRT_solver<dimension>::solve_k_rrts(std::list<std::array<double, dimension>
 
 template <int dimension> Graph<dimension> &RRT_solver<dimension>::get_tree() { return graph; }
 
+template <int dimension> Graph<dimension> &RRT_solver<dimension>::get_goal_tree() { return goal_graph; }
+
+template <int dimension> int RRT_solver<dimension>::get_iterations() const { return iterations; }
+
+template <int dimension>
+std::chrono::steady_clock::duration RRT_solver<dimension>::get_first_solution_time() const {
+    return first_solution;
+}
+
+template <int dimension> void RRT_solver<dimension>::set_caching(bool enabled) { caching = enabled; }
+
+template <int dimension> void RRT_solver<dimension>::set_profiling(bool enabled) { profiling = enabled; }
+
+template <int dimension> Solve_report RRT_solver<dimension>::get_solve_report() const {
+    return profiler.get_report();
+}
+
+template <int dimension>
+const typename RRT_solver<dimension>::Rewire_stats &RRT_solver<dimension>::get_rewire_stats() const {
+    return rewire_stats;
+}
+
+template <int dimension> void RRT_solver<dimension>::set_safe_ball_caching(bool enabled) {
+    safe_ball_caching = enabled;
+}
+
+template <int dimension>
+const typename Safe_ball_cache<dimension>::Stats &RRT_solver<dimension>::get_safe_ball_stats() const {
+    return safe_balls.get_stats();
+}
+
+template <int dimension> void RRT_solver<dimension>::set_segment_validation(Segment_validation mode) {
+    segment_validation = mode;
+}
+
+template <int dimension> void RRT_solver<dimension>::set_threads(size_t threads) {
+    worker_contexts.clear();
+    if (threads <= 1) {
+        pool.reset();
+        return;
+    }
+    pool = std::make_unique<Thread_pool>(threads);
+    for (size_t i = 0; i < threads; i++) {
+        worker_contexts.push_back(detector->create_context());
+    }
+}
+
+template <int dimension> void RRT_solver<dimension>::set_informed_sampling(bool enabled, bool pruning) {
+    informed = enabled;
+    this->pruning = enabled && pruning;
+}
+
+template <int dimension> void RRT_solver<dimension>::set_goal_radius(double radius) { goal_radius = radius; }
+
+template <int dimension> double RRT_solver<dimension>::get_goal_cost() const { return goal_cost; }
+
+template <int dimension> size_t RRT_solver<dimension>::get_pruned_vertices() const { return pruned_vertices; }
+
+template <int dimension> void RRT_solver<dimension>::set_seed(unsigned seed) { gen.seed(seed); }
+
+template <int dimension> void RRT_solver<dimension>::set_shared_bound(Shared_bound *bound) { shared_bound = bound; }
+
+template <int dimension>
+const typename Collision_cache<dimension>::Stats &RRT_solver<dimension>::get_cache_stats() const {
+    return cache.get_stats();
+}
+
+template <int dimension> void RRT_solver<dimension>::start_solve(const std::array<double, dimension> &start_state) {
+    if (!context) {
+        context = detector->create_context();
+    }
+    graph.clear();
+    cache.clear();
+    safe_balls.clear();
+    rewire_stats = Rewire_stats();
+    profiler.reset();
+    solve_start = std::chrono::steady_clock::now();
+    first_solution = std::chrono::steady_clock::duration::max();
+    graph.add_vertex(start_state);
+    iterations = 0;
+    anytime = false;
+    goal_candidates.clear();
+    goal_cost = std::numeric_limits<double>::infinity();
+    pruned_cost = std::numeric_limits<double>::infinity();
+    pruned_vertices = 0;
+}
+
 template <int dimension> std::array<double, dimension> RRT_solver<dimension>::get_random_state() {
+    Solve_profiler::Timer timer(profile(profiler.sampling));
     std::array<double, dimension> state;
     for (int i = 0; i < dimension; i++) {
         std::uniform_real_distribution<double> dis(boundaries[i][0], boundaries[i][1]);
@@ -126,33 +554,49 @@ template <int dimension> std::array<double, dimension> RRT_solver<dimension>::ge
 template <int dimension> std::array<double, dimension> RRT_solver<dimension>::get_random_free_state() {
     while (true) {
         std::array<double, dimension> state = get_random_state();
-        if (detector->check_collision(state.data())) {
+        if (check_state(state)) {
             return state;
         }
+        if (profiling) {
+            profiler.rejected_samples++;
+        }
     }
 }
 
 template <int dimension>
 bool RRT_solver<dimension>::get_free_states(std::vector<std::array<double, dimension>> &new_states,
-                                            std::array<double, dimension> &start, std::array<double, dimension> &stop,
-                                            double delta) {
+                                            const std::array<double, dimension> &start,
+                                            const std::array<double, dimension> &stop, double delta) {
+    Solve_profiler::Timer timer(profile(profiler.edge_validations));
+    Trace_scope trace("edge_validation", "collision");
     std::array<double, dimension> direction = vector_diff(stop, start);
     double distance = vector_norm(direction);
 
     direction = vector_mult(1.0 / distance, direction); // normalizing to 1.0 norm
 
     int iters = (int)(distance / delta);
+    int free_until = 0; // states up to this index are inside of the free ball of some checked state
     for (int i = 1; i <= iters; i++) {
-        auto new_state = vector_add(start, vector_mult(i * delta, direction));
+        auto new_state = vector_add_scaled(start, i * delta, direction);
 
-        if (!detector->check_collision(new_state.data())) {
-            return false;
+        if (i > free_until && !(safe_ball_caching && safe_balls.contains(new_state))) {
+            if (segment_validation == CONSERVATIVE_ADVANCEMENT) {
+                double radius = detector->get_free_radius(new_state.data(), *context, delta);
+                if (radius > 0.0) {
+                    // states closer than the radius are free (radius can be infinite):
+                    free_until = i + (int)std::ceil(std::min(radius / delta, (double)iters)) - 1;
+                } else if (!query_detector(new_state, *context)) {
+                    return false;
+                }
+            } else if (!query_detector(new_state, *context)) {
+                return false;
+            }
         }
         new_states.push_back(new_state);
     }
 
     // try adding goal state at the end:
-    if (detector->check_collision(stop.data())) {
+    if (check_state(stop)) {
         new_states.push_back(stop);
         return true;
     }
@@ -161,24 +605,22 @@ bool RRT_solver<dimension>::get_free_states(std::vector<std::array<double, dimen
 }
 
 template <int dimension>
-bool RRT_solver<dimension>::is_collision_free(std::array<double, dimension> &start, std::array<double, dimension> &stop,
-                                              double delta) {
+bool RRT_solver<dimension>::is_collision_free(const std::array<double, dimension> &start,
+                                              const std::array<double, dimension> &stop, double delta) {
+    Solve_profiler::Timer timer(profile(profiler.edge_validations));
+    Trace_scope trace("edge_validation", "collision");
     std::array<double, dimension> direction = vector_diff(stop, start);
     double distance = vector_norm(direction);
 
     direction = vector_mult(1.0 / distance, direction); // normalizing to 1.0 norm
 
-    int iters = (int)(distance / delta);
-    for (int i = 1; i <= iters; i++) {
-        auto new_state = vector_add(start, vector_mult(i * delta, direction));
-
-        if (!detector->check_collision(new_state.data())) {
-            return false;
-        }
+    if (!check_segment(start, direction, (int)(distance / delta), delta, *context,
+                       safe_ball_caching ? &safe_balls : nullptr)) {
+        return false;
     }
 
     // checking stop state aswell
-    if (detector->check_collision(stop.data())) {
+    if (check_state(stop)) {
         return true;
     }
 
@@ -186,47 +628,573 @@ bool RRT_solver<dimension>::is_collision_free(std::array<double, dimension> &sta
 }
 
 template <int dimension>
-std::array<double, dimension> RRT_solver<dimension>::move_a_step(std::array<double, dimension> &start,
-                                                                 std::array<double, dimension> &direction,
-                                                                 double step_size, double delta) {
+bool RRT_solver<dimension>::is_collision_free(uint32_t start_id, const std::array<double, dimension> &start,
+                                              uint32_t stop_id, const std::array<double, dimension> &stop,
+                                              double delta) {
+    bool is_free;
+    if (caching && cache.find_segment(start_id, stop_id, is_free)) {
+        return is_free;
+    }
+
+    // segment is validated always in the same direction, so the result does not depend on the order of the vertices
+    is_free = start_id < stop_id ? is_collision_free(start, stop, delta) : is_collision_free(stop, start, delta);
+    if (caching) {
+        cache.store_segment(start_id, stop_id, is_free);
+    }
+    return is_free;
+}
+
+template <int dimension>
+bool RRT_solver<dimension>::is_collision_free(const std::array<double, dimension> &start,
+                                              const std::array<double, dimension> &stop, double delta,
+                                              Collision_context &worker_context) const {
+    Solve_profiler::Timer timer(profile(profiler.edge_validations));
+    Trace_scope trace("edge_validation", "collision");
+    std::array<double, dimension> direction = vector_diff(stop, start);
+    double distance = vector_norm(direction);
+
+    direction = vector_mult(1.0 / distance, direction); // normalizing to 1.0 norm
+
+    if (!check_segment(start, direction, (int)(distance / delta), delta, worker_context, nullptr)) {
+        return false;
+    }
+
+    return query_detector(stop, worker_context);
+}
+
+template <int dimension>
+bool RRT_solver<dimension>::check_segment(const std::array<double, dimension> &start,
+                                          const std::array<double, dimension> &direction, int count, double delta,
+                                          Collision_context &query_context,
+                                          Safe_ball_cache<dimension> *balls) const {
+    auto is_free = [&](const std::array<double, dimension> &state) {
+        return (balls && balls->contains(state)) || query_detector(state, query_context);
+    };
+
+    switch (segment_validation) {
+    case BISECTION:
+        // indices are visited by decreasing powers of two dividing them - the middle of the path first, then the
+        // middles of the halves etc. (every index is visited exactly once):
+        for (int stride = (int)std::bit_ceil((unsigned)std::max(count, 1)); stride >= 1; stride /= 2) {
+            for (int i = stride; i <= count; i += 2 * stride) {
+                if (!is_free(vector_add_scaled(start, i * delta, direction))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    case CONSERVATIVE_ADVANCEMENT:
+        for (int i = 1; i <= count;) {
+            auto state = vector_add_scaled(start, i * delta, direction);
+            if (balls && balls->contains(state)) {
+                i++;
+                continue;
+            }
+            double radius = detector->get_free_radius(state.data(), query_context, delta);
+            if (radius > 0.0) {
+                // skipping states closer than the radius (radius can be infinite):
+                i += std::max(1, (int)std::ceil(std::min(radius / delta, (double)count)));
+            } else if (query_detector(state, query_context)) {
+                i++;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    default:
+        // states are passed to the detector in batches (in order from the start of the path):
+        for (int first = 1; first <= count; first += SEGMENT_BATCH) {
+            std::array<std::array<double, dimension>, SEGMENT_BATCH> states;
+            bool results[SEGMENT_BATCH];
+            size_t pending = 0;
+            for (int i = first; i <= std::min(count, first + SEGMENT_BATCH - 1); i++) {
+                states[pending] = vector_add_scaled(start, i * delta, direction);
+                if (!(balls && balls->contains(states[pending]))) {
+                    pending++;
+                }
+            }
+            {
+                Solve_profiler::Timer timer(profile(profiler.collision_checks), pending);
+                Trace_scope trace("collision_batch", "collision");
+                trace.set_arg("states", pending);
+                detector->check_collisions(states[0].data(), pending, dimension, results, query_context);
+            }
+            if (std::find(results, results + pending, false) != results + pending) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template <int dimension>
+void RRT_solver<dimension>::validate_edges(std::vector<signed char> &edges,
+                                           const std::vector<typename Graph<dimension>::Vertex> &k_nearest,
+                                           double min_cost, uint32_t new_id,
+                                           const std::array<double, dimension> &new_state, double delta) {
+    // parent candidates sorted by the cost of the new vertex through them (stable sort keeps the order of the serial
+    // version for equal costs):
+    std::vector<std::pair<double, size_t>> candidates;
+    for (size_t j = 0; j < k_nearest.size(); j++) {
+        double cost = k_nearest[j].cost() + vector_distance(k_nearest[j].coords(), new_state);
+        if (cost < min_cost) {
+            candidates.push_back({cost, j});
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    // candidates are validated in waves of pool size - the first free candidate is the parent chosen by the serial
+    // version, so the validation can stop after the wave in which it is found:
+    std::vector<size_t> batch;
+    for (size_t begin = 0; begin < candidates.size(); begin += pool->size()) {
+        size_t end = std::min(begin + pool->size(), candidates.size());
+        batch.clear();
+        for (size_t c = begin; c < end; c++) {
+            batch.push_back(candidates[c].second);
+        }
+        validate_batch(edges, k_nearest, batch, new_id, new_state, delta);
+
+        bool found = false;
+        for (size_t c = begin; c < end && !found; c++) {
+            if (edges[candidates[c].second] == 1) {
+                min_cost = candidates[c].first;
+                found = true;
+            }
+        }
+        if (found) {
+            break;
+        }
+    }
+
+    // with the final cost of the new vertex known, edges for the rewiring are validated at once:
+    batch.clear();
+    for (size_t j = 0; j < k_nearest.size(); j++) {
+        if (edges[j] < 0 && min_cost + vector_distance(k_nearest[j].coords(), new_state) < k_nearest[j].cost()) {
+            batch.push_back(j);
+        }
+    }
+    validate_batch(edges, k_nearest, batch, new_id, new_state, delta);
+}
+
+template <int dimension>
+void RRT_solver<dimension>::validate_batch(std::vector<signed char> &edges,
+                                           const std::vector<typename Graph<dimension>::Vertex> &k_nearest,
+                                           std::vector<size_t> &batch, uint32_t new_id,
+                                           const std::array<double, dimension> &new_state, double delta) {
+    if (caching) { // edges which are already in the cache are not validated again
+        size_t size = 0;
+        for (size_t j : batch) {
+            bool is_free;
+            if (cache.find_segment(k_nearest[j].id(), new_id, is_free)) {
+                edges[j] = is_free;
+            } else {
+                batch[size++] = j;
+            }
+        }
+        batch.resize(size);
+    }
+
+    // edges are validated from the neighbour to the new state - in the same direction as by the serial version
+    pool->parallel_for(batch.size(), [&](size_t i, size_t worker) {
+        auto neighbour = k_nearest[batch[i]];
+        edges[batch[i]] = is_collision_free(neighbour.coords(), new_state, delta, *worker_contexts[worker]);
+    });
+
+    if (caching) {
+        for (size_t j : batch) {
+            cache.store_segment(k_nearest[j].id(), new_id, edges[j] == 1);
+        }
+    }
+}
+
+template <int dimension>
+std::array<double, dimension>
+RRT_solver<dimension>::get_informed_state(const std::array<double, dimension> &start_state,
+                                          const std::array<double, dimension> &goal_state, double best_cost) {
+    double min_cost = vector_distance(start_state, goal_state);
+    // radii of the hyperspheroid - along the axis from start to goal and in all of the other directions:
+    double major_radius = best_cost / 2.0;
+    // (rounding errors of the path costs or a cost offered by other solver can leave best_cost slightly under min_cost)
+    double minor_radius = std::sqrt(std::max(0.0, best_cost * best_cost - min_cost * min_cost)) / 2.0;
+
+    // sampling the whole space is cheaper if the hyperspheroid is larger than the boundaries (the caller rejects states
+    // outside of it):
+    double volume = std::pow(M_PI, dimension / 2.0) / std::tgamma(dimension / 2.0 + 1.0) * major_radius *
+                    std::pow(minor_radius, dimension - 1);
+    double bounds_volume = 1.0;
+    for (int i = 0; i < dimension; i++) {
+        bounds_volume *= boundaries[i][1] - boundaries[i][0];
+    }
+    if (min_cost <= 0.0 || volume >= bounds_volume) {
+        return get_random_state();
+    }
+    Solve_profiler::Timer timer(profile(profiler.sampling));
+
+    // orthonormal basis with the first axis from start to goal (Gram-Schmidt process on the standard basis):
+    std::array<std::array<double, dimension>, dimension> basis;
+    basis[0] = vector_mult(1.0 / min_cost, vector_diff(goal_state, start_state));
+    int axes = 1;
+    for (int i = 0; i < dimension && axes < dimension; i++) {
+        std::array<double, dimension> axis = {};
+        axis[i] = 1.0;
+        for (int j = 0; j < axes; j++) {
+            axis = vector_add_scaled(axis, -vector_dot(axis, basis[j]), basis[j]);
+        }
+        double norm = vector_norm(axis);
+        if (norm > 1e-6) {
+            basis[axes++] = vector_mult(1.0 / norm, axis);
+        }
+    }
+
+    std::array<double, dimension> center = vector_mult(0.5, vector_add(start_state, goal_state));
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> uniform;
+    while (true) {
+        // uniform sample from the unit ball:
+        std::array<double, dimension> ball;
+        for (int i = 0; i < dimension; i++) {
+            ball[i] = normal(gen);
+        }
+        ball = vector_mult(std::pow(uniform(gen), 1.0 / dimension) / vector_norm(ball), ball);
+
+        // transforming the ball to the hyperspheroid:
+        std::array<double, dimension> state = center;
+        for (int i = 0; i < dimension; i++) {
+            state = vector_add_scaled(state, (i == 0 ? major_radius : minor_radius) * ball[i], basis[i]);
+        }
+
+        bool inside = true;
+        for (int i = 0; i < dimension; i++) {
+            inside = inside && state[i] >= boundaries[i][0] && state[i] <= boundaries[i][1];
+        }
+        if (inside) {
+            return state;
+        }
+    }
+}
+
+template <int dimension> double RRT_solver<dimension>::get_best_cost() const {
+    return shared_bound ? std::min(goal_cost, shared_bound->get()) : goal_cost;
+}
+
+template <int dimension>
+bool RRT_solver<dimension>::is_pruned(const std::array<double, dimension> &state,
+                                      const std::array<double, dimension> &start_state,
+                                      const std::array<double, dimension> &goal_state) const {
+    return vector_distance(start_state, state) + vector_distance(state, goal_state) >= get_best_cost();
+}
+
+template <int dimension>
+void RRT_solver<dimension>::offer_goal_path(Graph<dimension>::Vertex vertex,
+                                            const std::array<double, dimension> &goal_state, double delta) {
+    double distance_sq = vector_distance_sq(vertex.coords(), goal_state);
+    if (distance_sq > goal_region * goal_region) { // most of the offered vertices are outside of the goal region
+        return;
+    }
+    double distance = std::sqrt(distance_sq);
+    if (vertex.id() == goal_parent && goal_cost < std::numeric_limits<double>::infinity()) {
+        goal_cost = vertex.cost() + distance; // cost of the best path dropped (it's last edge is already validated)
+        if (shared_bound) {
+            shared_bound->offer(goal_cost);
+        }
+    } else if (vertex.cost() + distance < get_best_cost() &&
+        is_collision_free(vertex.id(), vertex.coords(), GOAL_ID, goal_state, delta)) {
+        goal_cost = vertex.cost() + distance;
+        goal_parent = vertex.id();
+        record_solution();
+        if (shared_bound) {
+            shared_bound->offer(goal_cost);
+        }
+    }
+}
+
+template <int dimension>
+void RRT_solver<dimension>::offer_subtree_goal_paths(Graph<dimension>::Vertex vertex,
+                                                     const std::array<double, dimension> &goal_state, double delta) {
+    subtree.clear();
+    subtree.push_back(vertex);
+    while (!subtree.empty()) {
+        auto current = subtree.back();
+        subtree.pop_back();
+        if (lazy) {
+            offer_lazy_goal_path(current, goal_state, delta);
+        } else {
+            offer_goal_path(current, goal_state, delta);
+        }
+        for (auto child = current.first_child(); child; child = child.next_sibling()) {
+            subtree.push_back(child);
+        }
+    }
+}
+
+template <int dimension>
+void RRT_solver<dimension>::offer_lazy_goal_path(Graph<dimension>::Vertex vertex,
+                                                 const std::array<double, dimension> &goal_state, double delta) {
+    double distance_sq = vector_distance_sq(vertex.coords(), goal_state);
+    if (distance_sq > goal_region * goal_region) {
+        return;
+    }
+    double distance = std::sqrt(distance_sq);
+    while (vertex.cost() + distance < goal_cost) { // repairs change the cost of the vertex (infinity if cut off)
+        if (!is_collision_free(vertex.id(), vertex.coords(), GOAL_ID, goal_state, delta)) {
+            return;
+        }
+        auto colliding = validate_path(vertex, delta);
+        if (!colliding) {
+            goal_cost = vertex.cost() + distance;
+            goal_parent = vertex.id();
+            record_solution();
+            return;
+        }
+
+        repair_vertex(colliding);
+        if (goal_cost < std::numeric_limits<double>::infinity()) {
+            auto parent = graph.get_vertex(goal_parent);
+            if (parent.cost() + vector_distance(parent.coords(), goal_state) != goal_cost) {
+                // the repair rerouted the best path (through not validated edges) -> it's found again by the offers
+                goal_cost = std::numeric_limits<double>::infinity();
+            }
+        }
+    }
+}
+
+template <int dimension> bool RRT_solver<dimension>::check_state(const std::array<double, dimension> &state) {
+    bool is_free;
+    if (caching && cache.find_state(state, is_free)) {
+        return is_free;
+    }
+
+    if (safe_ball_caching && safe_balls.contains(state)) {
+        is_free = true;
+    } else {
+        is_free = query_detector(state, *context);
+        if (is_free && safe_ball_caching) {
+            safe_balls.insert(state, detector->get_free_radius(state.data(), *context, 0.0));
+        }
+    }
+    if (caching) {
+        cache.store_state(state, is_free);
+    }
+    return is_free;
+}
+
+template <int dimension>
+std::array<double, dimension> RRT_solver<dimension>::move_a_step(const std::array<double, dimension> &start,
+                                                                 const std::array<double, dimension> &direction,
+                                                                 double step_size, double delta, bool &reachable) {
+    reachable = true;
     std::array<double, dimension> diff = vector_diff(direction, start);
     double distance = vector_norm(diff);
     if (distance <= delta) {
         return direction;
     }
     diff = vector_mult(1.0 / distance, diff); // normalizing to 1.0 norm
-    auto stop = vector_add(start, vector_mult(step_size, diff));
+    auto stop = vector_add_scaled(start, step_size, diff);
 
     std::vector<std::array<double, dimension>> new_states;
     get_free_states(new_states, start, stop, delta);
     if (new_states.size() <= 0) {
+        reachable = false;
         return direction;
     }
     return new_states.back();
 }
 
+template <int dimension>
+Graph<dimension>::Vertex RRT_solver<dimension>::extend(Graph<dimension> &tree,
+                                                       const std::array<double, dimension> &target, double step,
+                                                       double delta, bool &reached) {
+    auto nearest = get_nearest(tree, target);
+    double distance = vector_distance(nearest.coords(), target);
+    if (distance == 0.0) { // target is already in the tree
+        reached = true;
+        return nearest;
+    }
+
+    std::array<double, dimension> stop = target;
+    if (distance > step) {
+        stop = vector_add_scaled(nearest.coords(), step / distance, vector_diff(target, nearest.coords()));
+    }
+
+    std::vector<std::array<double, dimension>> new_states;
+    reached = get_free_states(new_states, nearest.coords(), stop, delta) && distance <= step;
+    if (new_states.empty()) {
+        return typename Graph<dimension>::Vertex();
+    }
+    return insert_vertex(tree, new_states.back(), nearest, vector_distance(nearest.coords(), new_states.back()));
+}
+
+template <int dimension>
+std::array<double, dimension> RRT_solver<dimension>::steer(const std::array<double, dimension> &start,
+                                                           const std::array<double, dimension> &direction,
+                                                           double step_size) {
+    std::array<double, dimension> diff = vector_diff(direction, start);
+    double distance = vector_norm(diff);
+    if (distance <= step_size) {
+        return direction;
+    }
+    return vector_add_scaled(start, step_size / distance, diff);
+}
+
+template <int dimension>
+Graph<dimension>::Vertex RRT_solver<dimension>::validate_path(Graph<dimension>::Vertex vertex, double delta) {
+    std::vector<typename Graph<dimension>::Vertex> path;
+    for (auto current = vertex; current.parent(); current = current.parent()) {
+        path.push_back(current);
+    }
+
+    for (auto it = path.rbegin(); it != path.rend(); it++) { // from the root to the vertex
+        auto parent = it->parent();
+        if (!is_collision_free(parent.id(), parent.coords(), it->id(), it->coords(), delta)) {
+            return *it;
+        }
+    }
+    return typename Graph<dimension>::Vertex();
+}
+
+template <int dimension>
+Solve_profiler::Phase *RRT_solver<dimension>::profile(Solve_profiler::Phase &phase) const {
+    return profiling ? &phase : nullptr;
+}
+
+template <int dimension>
+Graph<dimension>::Vertex RRT_solver<dimension>::get_nearest(const Graph<dimension> &tree,
+                                                            const std::array<double, dimension> &state) const {
+    Solve_profiler::Timer timer(profile(profiler.nearest_queries));
+    Trace_scope trace("nearest", "nearest");
+    return tree.get_nearest(state);
+}
+
+template <int dimension>
+void RRT_solver<dimension>::get_k_nearest(Graph<dimension> &tree,
+                                          std::vector<typename Graph<dimension>::Vertex> &k_nearest,
+                                          const std::array<double, dimension> &state, size_t k) const {
+    Solve_profiler::Timer timer(profile(profiler.nearest_queries));
+    Trace_scope trace("k_nearest", "nearest");
+    trace.set_arg("k", k);
+    tree.get_k_nearest(k_nearest, state, k);
+}
+
+template <int dimension>
+Graph<dimension>::Vertex RRT_solver<dimension>::insert_vertex(Graph<dimension> &tree,
+                                                              const std::array<double, dimension> &state,
+                                                              Graph<dimension>::Vertex parent, double weight) const {
+    Solve_profiler::Timer timer(profile(profiler.insertions));
+    return tree.connect_new_vertex(state, parent, weight);
+}
+
+template <int dimension>
+bool RRT_solver<dimension>::query_detector(const std::array<double, dimension> &state,
+                                           Collision_context &query_context) const {
+    Solve_profiler::Timer timer(profile(profiler.collision_checks));
+    return detector->check_collision(state.data(), query_context);
+}
+
+template <int dimension> void RRT_solver<dimension>::record_solution() {
+    if (first_solution == std::chrono::steady_clock::duration::max()) {
+        first_solution = std::chrono::steady_clock::now() - solve_start;
+    }
+}
+
+template <int dimension>
+size_t RRT_solver<dimension>::rewire(Graph<dimension>::Vertex vertex, Graph<dimension>::Vertex new_parent,
+                                     double weight) {
+    Solve_profiler::Timer timer(profile(profiler.rewires));
+    Trace_scope trace("rewire", "rrt");
+    size_t cascade = graph.rewire_vertex(vertex, new_parent, weight);
+    trace.set_arg("cascade", cascade);
+    rewire_stats.rewires++;
+    rewire_stats.cascade_total += cascade;
+    rewire_stats.cascade_max = std::max(rewire_stats.cascade_max, cascade);
+    return cascade;
+}
+
+template <int dimension> void RRT_solver<dimension>::repair_vertex(Graph<dimension>::Vertex vertex) {
+    // detaching sets the cost of the whole subtree to infinity, so the descendants are never chosen as new parents
+    graph.detach_vertex(vertex);
+
+    // collecting the cut off subtree (parents are before their children):
+    std::vector<typename Graph<dimension>::Vertex> orphans = {vertex};
+    for (size_t i = 0; i < orphans.size(); i++) {
+        for (auto child = orphans[i].first_child(); child; child = child.next_sibling()) {
+            orphans.push_back(child);
+        }
+    }
+
+    // lazily reconnecting the orphans to the cheapest neighbours which are still connected to the root (edges already
+    // found colliding are skipped, the new edges are validated only if they end up on the best path again)
+    int k = (int)(2 * M_E * std::log(graph.size()));
+    std::vector<typename Graph<dimension>::Vertex> k_nearest;
+    bool reconnected = true;
+    while (reconnected) {
+        reconnected = false;
+        for (auto orphan : orphans) {
+            if (orphan.cost() < std::numeric_limits<double>::infinity()) {
+                continue; // already reconnected together with it's ancestor
+            }
+
+            k_nearest.clear();
+            get_k_nearest(graph, k_nearest, orphan.coords(), k);
+            typename Graph<dimension>::Vertex min_state;
+            double min_cost = std::numeric_limits<double>::infinity();
+            for (auto neighbour : k_nearest) {
+                double cost = neighbour.cost() + vector_distance(neighbour.coords(), orphan.coords());
+                if (cost < min_cost && !cache.is_known_colliding(neighbour.id(), orphan.id())) {
+                    min_state = neighbour;
+                    min_cost = cost;
+                }
+            }
+
+            if (min_state) {
+                rewire(orphan, min_state, vector_distance(min_state.coords(), orphan.coords()));
+                reconnected = true;
+            }
+        }
+    }
+}
+
 template <int dimension>
 void RRT_solver<dimension>::construct_result_plan(std::list<std::array<double, dimension>> &result_plan,
-                                                  Graph<dimension>::Vertex *goal_vertex) {
+                                                  Graph<dimension>::Vertex goal_vertex) {
     auto current = goal_vertex;
-    while (current != nullptr) {
-        result_plan.push_front(current->coords);
-        current = current->parent;
+    while (current) {
+        result_plan.push_front(current.coords());
+        current = current.parent();
     }
 }
 
 template <int dimension>
 void RRT_solver<dimension>::construct_result_plan(std::list<std::array<double, dimension>> &result_plan,
-                                                  Graph<dimension>::Vertex *goal_vertex, double delta) {
+                                                  Graph<dimension>::Vertex goal_vertex, double delta) {
     auto current = goal_vertex;
-    while (current->parent != nullptr) {
+    while (current.parent()) {
         std::vector<std::array<double, dimension>> new_states;
-        get_free_states(new_states, current->coords, current->parent->coords, delta);
+        get_free_states(new_states, current.coords(), current.parent().coords(), delta);
         for (const auto &state : new_states) {
             result_plan.push_front(state);
         }
-        current = current->parent;
+        current = current.parent();
+    }
+
+    result_plan.push_front(current.coords());
+}
+
+template <int dimension>
+void RRT_solver<dimension>::append_edge(std::list<std::array<double, dimension>> &result_plan,
+                                        const std::array<double, dimension> &start,
+                                        const std::array<double, dimension> &stop, double delta) {
+    std::vector<std::array<double, dimension>> new_states;
+    if (get_free_states(new_states, start, stop, delta)) {
+        result_plan.insert(result_plan.end(), new_states.begin(), new_states.end());
+        return;
     }
 
-    result_plan.push_front(current->coords);
+    new_states.clear();
+    get_free_states(new_states, stop, start, delta);
+    if (!new_states.empty() && new_states.back() == start) {
+        new_states.pop_back(); // start is already in the plan
+    }
+    result_plan.insert(result_plan.end(), new_states.rbegin(), new_states.rend());
+    result_plan.push_back(stop);
 }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "kd_tree.hpp"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Cache of the free space around the validated states. Every cached state is stored together with the radius of the
+ * ball around it which contains only permissible states (see Collision_detector::get_free_radius), so any state
+ * inside of some of the balls is known to be permissible without calling the collision detector. Centers of the balls
+ * are indexed by the k-d tree and a lookup examines only the balls with the nearest centers.
+ *
+ * @tparam dimension - number of dimensions of the configuration space
+ */
+template <int dimension> class Safe_ball_cache {
+  public:
+    struct Stats {
+        size_t hits = 0;   // lookups inside of some ball
+        size_t misses = 0; // lookups outside of all examined balls
+        size_t balls = 0;  // number of cached balls
+    };
+
+  private:
+    static constexpr size_t CANDIDATES = 4; // number of the nearest balls examined by a lookup
+
+    Kd_tree<dimension> centers;
+    std::vector<double> radii; // indexed by the ids of the centers
+    Stats stats;
+
+  public:
+    /**
+     * Returns true if the state lies inside of some of the cached balls (it's permissible then).
+     */
+    bool contains(const std::array<double, dimension> &state) {
+        for (const auto &[distance_sq, id] : centers.k_nearest(state, CANDIDATES)) {
+            if (distance_sq < radii[id] * radii[id]) {
+                stats.hits++;
+                return true;
+            }
+        }
+        stats.misses++;
+        return false;
+    }
+
+    /**
+     * Caches the ball with the given center and radius (balls with zero radius are ignored).
+     */
+    void insert(const std::array<double, dimension> &center, double radius) {
+        if (radius <= 0.0) {
+            return;
+        }
+        centers.insert(center);
+        radii.push_back(radius);
+        stats.balls++;
+    }
+
+    const Stats &get_stats() const { return stats; }
+
+    /** Removes all balls and resets the statistics. */
+    void clear() {
+        centers.clear();
+        radii.clear();
+        stats = Stats();
+    }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+/**
+ * Cost of the best path to the goal found so far, shared between the solvers running in parallel (see
+ * Parallel_RRT_solver). Solvers publish costs of their paths with offer and read the bound to prune the states which
+ * can not lead to a better path.
+ */
+class Shared_bound {
+  private:
+    std::atomic<double> cost{std::numeric_limits<double>::infinity()};
+
+  public:
+    /** Returns the cost of the best path found so far (infinity if no path was found yet). */
+    double get() const { return cost.load(std::memory_order_relaxed); }
+
+    /** Returns true if some of the solvers already found a path. */
+    bool is_solved() const { return get() < std::numeric_limits<double>::infinity(); }
+
+    /**
+     * Lowers the bound to the new_cost if it is better than the current one.
+     *
+     * @return true if the bound was lowered
+     */
+    bool offer(double new_cost) {
+        double current = cost.load(std::memory_order_relaxed);
+        while (new_cost < current) {
+            if (cost.compare_exchange_weak(current, new_cost, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void reset() { cost.store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed); }
+};
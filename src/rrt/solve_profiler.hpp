@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Counters and cumulative times of the phases of one solve (see RRT_solver::set_profiling). Phases are nested, so their
+ * times overlap - e.g. the edge validations include the collision checks of their states.
+ */
+struct Solve_report {
+    struct Phase {
+        size_t count = 0;  // number of operations
+        double time = 0.0; // cumulative time of the operations in seconds
+    };
+
+    Phase solve;                 // "solve" calls (solve_anytime can be called multiple times per session)
+    Phase sampling;              // random states drawn (including the rejected ones)
+    size_t rejected_samples = 0; // colliding random states rejected by the sampling of the free states
+    Phase nearest_queries;       // nearest and k-nearest neighbour queries
+    Phase collision_checks;      // states passed to the collision detector
+    Phase edge_validations;      // paths between two states checked state by state (collision cache hits excluded)
+    Phase rewires;               // rewired vertices (including the cost updates of their subtrees)
+    Phase insertions;            // vertices inserted into the trees and their nearest neighbour indices
+};
+
+/**
+ * Thread safe accumulator of the phases of a solve (the edges are validated also by the workers of the thread pool).
+ */
+class Solve_profiler {
+  public:
+    /** Accumulated operations and time of one phase. */
+    class Phase {
+        std::atomic<size_t> count{0};
+        std::atomic<int64_t> nanoseconds{0};
+
+      public:
+        void add(size_t operations, std::chrono::steady_clock::duration time) {
+            count.fetch_add(operations, std::memory_order_relaxed);
+            nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+                                  std::memory_order_relaxed);
+        }
+        void reset() {
+            count = 0;
+            nanoseconds = 0;
+        }
+        Solve_report::Phase get() const { return {count.load(), nanoseconds.load() * 1e-9}; }
+    };
+
+    /**
+     * Measures the lifetime of the scope and adds it to the phase. Does nothing (not even reading the clock) if the
+     * phase is null, so disabled profiling costs a single branch.
+     */
+    class Timer {
+        Phase *phase;
+        size_t operations;
+        std::chrono::steady_clock::time_point start;
+
+      public:
+        explicit Timer(Phase *phase, size_t operations = 1) : phase(phase), operations(operations) {
+            if (phase) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+        ~Timer() {
+            if (phase) {
+                phase->add(operations, std::chrono::steady_clock::now() - start);
+            }
+        }
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+    };
+
+    Phase solve, sampling, nearest_queries, collision_checks, edge_validations, rewires, insertions;
+    std::atomic<size_t> rejected_samples{0};
+
+    void reset() {
+        for (Phase *phase : {&solve, &sampling, &nearest_queries, &collision_checks, &edge_validations, &rewires,
+                             &insertions}) {
+            phase->reset();
+        }
+        rejected_samples = 0;
+    }
+
+    Solve_report get_report() const {
+        Solve_report report;
+        report.solve = solve.get();
+        report.sampling = sampling.get();
+        report.rejected_samples = rejected_samples.load();
+        report.nearest_queries = nearest_queries.get();
+        report.collision_checks = collision_checks.get();
+        report.edge_validations = edge_validations.get();
+        report.rewires = rewires.get();
+        report.insertions = insertions.get();
+        return report;
+    }
+};
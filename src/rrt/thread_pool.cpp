@@ -0,0 +1,109 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+Thread_pool::Thread_pool(size_t workers) {
+    workers = std::max(workers, (size_t)1);
+    for (size_t i = 0; i < workers; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 1; i < workers; i++) {
+        threads.emplace_back(&Thread_pool::worker_loop, this, i);
+    }
+}
+
+Thread_pool::~Thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+void Thread_pool::run(size_t count, void (*function)(void *, size_t, size_t), void *data) {
+    job = function;
+    job_data = data;
+    remaining.store(count);
+
+    // splitting the loop into chunks (several per worker, so the faster workers can steal from the slower ones):
+    size_t chunk = std::max(count / (size() * 4), (size_t)1);
+    size_t worker = 0;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+        queues[worker]->ranges.push_back({begin, std::min(begin + chunk, count)});
+        worker = (worker + 1) % size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+    }
+    wake.notify_all();
+
+    process(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return remaining.load() == 0; });
+}
+
+void Thread_pool::worker_loop(size_t worker) {
+    size_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+        }
+        process(worker);
+    }
+}
+
+/**
+ * Processes chunks of the current loop until there is nothing left to take or steal.
+ */
+void Thread_pool::process(size_t worker) {
+    Range range;
+    while (remaining.load() > 0 && pop(worker, range)) {
+        for (size_t i = range.first; i < range.second; i++) {
+            job(job_data, i, worker);
+        }
+
+        size_t processed = range.second - range.first;
+        if (remaining.fetch_sub(processed) == processed) {
+            std::lock_guard<std::mutex> lock(mutex); // last chunk of the loop -> waking the calling thread
+            done.notify_all();
+        }
+    }
+}
+
+/**
+ * Takes chunk from the back of the own queue or steals one from the front of the queue of another worker.
+ */
+bool Thread_pool::pop(size_t worker, Range &range) {
+    {
+        Queue &own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.ranges.empty()) {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < size(); i++) {
+        Queue &victim = *queues[(worker + i) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
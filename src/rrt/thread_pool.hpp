@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed size pool of worker threads executing parallel loops with work stealing.
+ *
+ * Indices of the loop are split into chunks which are distributed round robin to the deques of the workers. Every
+ * worker takes chunks from the back of it's own deque and when it runs out of work, it steals chunks from the front of
+ * the deques of the other workers. The thread calling parallel_for participates in the loop as the worker 0.
+ */
+class Thread_pool {
+  private:
+    typedef std::pair<size_t, size_t> Range; // [begin, end) of the loop indices
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues; // one for every worker (including the calling thread)
+
+    std::mutex mutex;
+    std::condition_variable wake; // signals new loop (or stopping) to the workers
+    std::condition_variable done; // signals end of the loop to the calling thread
+    size_t generation = 0;        // number of started loops
+    bool stopping = false;
+
+    std::atomic<size_t> remaining{0}; // number of indices of the current loop which were not processed yet
+    void (*job)(void *data, size_t index, size_t worker) = nullptr; // body of the current loop
+    void *job_data = nullptr;
+
+  public:
+    /**
+     * @param workers total number of workers including the thread calling parallel_for (workers - 1 threads are
+     * created)
+     */
+    explicit Thread_pool(size_t workers);
+    ~Thread_pool();
+
+    Thread_pool(const Thread_pool &) = delete;
+    Thread_pool &operator=(const Thread_pool &) = delete;
+
+    /** Returns the number of workers including the calling thread. */
+    size_t size() const { return queues.size(); }
+
+    /**
+     * Calls function(index, worker) for every index in [0, count) and returns after all of the calls are finished.
+     * Worker is the id of the executing worker in [0, size()) - it can be used to index per-thread data.
+     */
+    template <typename Function> void parallel_for(size_t count, Function &&function) {
+        if (count == 0) {
+            return;
+        }
+        run(count, &call<std::remove_reference_t<Function>>, (void *)&function);
+    }
+
+  private:
+    template <typename Function> static void call(void *data, size_t index, size_t worker) {
+        (*(Function *)data)(index, worker);
+    }
+
+    void run(size_t count, void (*function)(void *, size_t, size_t), void *data);
+    void worker_loop(size_t worker);
+    void process(size_t worker);
+    bool pop(size_t worker, Range &range);
+};
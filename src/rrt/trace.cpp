@@ -0,0 +1,132 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/** Ring buffer of the events of one thread. */
+struct Buffer {
+    std::vector<Trace::Event> events;
+    size_t next = 0;      // index of the next written event
+    bool wrapped = false; // true if the oldest events were overwritten
+    uint32_t thread_id;   // sequential id of the buffer (threads reusing the buffer share it's id)
+};
+
+std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+size_t capacity = Trace::DEFAULT_CAPACITY;
+std::mutex mutex;                             // guards the list of the buffers
+std::vector<std::unique_ptr<Buffer>> buffers; // buffers outlive their threads, so their events can be written
+std::vector<Buffer *> free_buffers;           // buffers of the exited threads (reused by the new threads)
+thread_local Buffer *buffer = nullptr;
+
+/** Returns the buffer of the thread to the free buffers when the thread exits. */
+struct Buffer_release {
+    Buffer *buffer = nullptr;
+    ~Buffer_release() {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            free_buffers.push_back(buffer);
+        }
+    }
+};
+thread_local Buffer_release buffer_release; // set by the first event of the thread
+
+/** Writes the nanoseconds as microseconds (the time unit of the trace event format). */
+void write_microseconds(std::ostream &out, int64_t nanoseconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%" PRId64 ".%03" PRId64, nanoseconds / 1000, nanoseconds % 1000);
+    out << text;
+}
+
+} // namespace
+
+void Trace::start(size_t new_capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = std::max(new_capacity, (size_t)1);
+    for (const std::unique_ptr<Buffer> &thread_buffer : buffers) {
+        thread_buffer->events.assign(capacity, Event());
+        thread_buffer->next = 0;
+        thread_buffer->wrapped = false;
+    }
+    origin = std::chrono::steady_clock::now();
+    enabled.store(true);
+}
+
+void Trace::stop() { enabled.store(false); }
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Trace::record(const Event &event) {
+    if (!buffer) { // first event of the thread
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_buffers.empty()) {
+            buffers.push_back(std::make_unique<Buffer>());
+            buffer = buffers.back().get();
+            buffer->events.resize(capacity);
+            buffer->thread_id = (uint32_t)(buffers.size() - 1);
+        } else { // events of the exited thread are kept, new events continue in it's ring
+            buffer = free_buffers.back();
+            free_buffers.pop_back();
+        }
+        buffer_release.buffer = buffer;
+    }
+    buffer->events[buffer->next] = event;
+    if (++buffer->next == buffer->events.size()) {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+void Trace::write_json(std::ostream &out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    std::vector<Event> events;
+    for (const std::unique_ptr<Buffer> &thread_buffer : buffers) {
+        out << (first ? "\n" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+            << thread_buffer->thread_id << ", \"args\": {\"name\": \"thread " << thread_buffer->thread_id << "\"}}";
+        first = false;
+
+        // events are stored at their end (inner scopes first), viewers expect them ordered by the start:
+        const std::vector<Event> &ring = thread_buffer->events;
+        events.clear();
+        if (thread_buffer->wrapped) { // the oldest events follow the next written one
+            events.assign(ring.begin() + thread_buffer->next, ring.end());
+        }
+        events.insert(events.end(), ring.begin(), ring.begin() + thread_buffer->next);
+        std::stable_sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+            return a.start < b.start || (a.start == b.start && a.duration > b.duration);
+        });
+
+        for (const Event &event : events) {
+            out << ",\n{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread_buffer->thread_id << ", \"ts\": ";
+            write_microseconds(out, event.start);
+            out << ", \"dur\": ";
+            write_microseconds(out, event.duration);
+            if (event.arg_name) {
+                out << ", \"args\": {\"" << event.arg_name << "\": " << event.arg_value << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}" << std::endl;
+}
+
+bool Trace::write_json(const std::string &file_name) {
+    std::ofstream file(file_name);
+    if (!file) {
+        return false;
+    }
+    write_json(file);
+    return (bool)file;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * Timeline of the planner execution exported as Chrome trace event JSON (it can be loaded offline by Perfetto or
+ * chrome://tracing).
+ *
+ * Events are recorded by Trace_scope objects into per thread ring buffers of a fixed capacity (the oldest events of
+ * the thread are overwritten), so recording neither locks nor allocates - except the first event of every thread,
+ * which registers its buffer. Buffers of the exited threads are reused by the new threads (e.g. the threads of the
+ * repeated parallel solves), so the memory is bounded by the number of the threads running at once. Disabled tracing
+ * costs one relaxed atomic load per scope.
+ *
+ * start, stop and write_json must not be called while the traced threads are recording events (e.g. in the middle of
+ * a solve).
+ */
+class Trace {
+  public:
+    struct Event {
+        const char *name;     // string literal (names are not copied)
+        const char *category; // string literal
+        int64_t start;        // nanoseconds since the start of the trace
+        int64_t duration;     // nanoseconds
+        const char *arg_name; // name of the optional numeric argument of the event (null if there is none)
+        int64_t arg_value;
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 16; // events per thread
+
+  private:
+    inline static std::atomic<bool> enabled{false};
+
+  public:
+    /** Starts a new recording (events of the previous one are discarded). */
+    static void start(size_t capacity = DEFAULT_CAPACITY);
+    /** Stops the recording, recorded events are kept until the next start. */
+    static void stop();
+    static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /** Returns the time since the start of the recording in nanoseconds. */
+    static int64_t now();
+    /** Stores the event to the buffer of the calling thread. */
+    static void record(const Event &event);
+
+    /** Writes the recorded events as Chrome trace event JSON (events of every thread are ordered by their start). */
+    static void write_json(std::ostream &out);
+    /** Writes the JSON to the file, returns false if the file can't be written. */
+    static bool write_json(const std::string &file_name);
+};
+
+/**
+ * Records the lifetime of the scope as a trace event (if the tracing is enabled at the construction).
+ */
+class Trace_scope {
+    const char *name; // null if the tracing is disabled
+    const char *category;
+    int64_t start = 0;
+    const char *arg_name = nullptr;
+    int64_t arg_value = 0;
+
+  public:
+    /** Name and category must be string literals (or other strings outliving the trace). */
+    Trace_scope(const char *name, const char *category)
+        : name(Trace::is_enabled() ? name : nullptr), category(category) {
+        if (this->name) {
+            start = Trace::now();
+        }
+    }
+    ~Trace_scope() {
+        if (name) {
+            Trace::record({name, category, start, Trace::now() - start, arg_name, arg_value});
+        }
+    }
+    Trace_scope(const Trace_scope &) = delete;
+    Trace_scope &operator=(const Trace_scope &) = delete;
+
+    /** Attaches the numeric argument to the event (shown with the event by the trace viewers). */
+    void set_arg(const char *arg_name, int64_t value) {
+        this->arg_name = arg_name;
+        arg_value = value;
+    }
+};
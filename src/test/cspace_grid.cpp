@@ -0,0 +1,146 @@
+#include "cspace_grid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "geometry_2D.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+constexpr double EPSILON = 1e-9; // safety margin of the classification (against rounding errors)
+
+} // namespace
+
+Cspace_grid::Cspace_grid(double width, double height, double cell_size, int slices)
+    : cell_size(cell_size), slice_angle(2 * M_PI / std::max(1, slices)),
+      columns(std::max(1, (int)std::ceil(width / cell_size))), rows(std::max(1, (int)std::ceil(height / cell_size))),
+      slices(std::max(1, slices)), slice_words(((size_t)columns * rows + 63) / 64),
+      free_cells(slice_words * this->slices), colliding_cells(slice_words * this->slices) {}
+
+void Cspace_grid::build(const Model_2D &robot, const std::vector<Model_2D *> &obstacles,
+                        const Obstacle_grid &obstacle_grid, size_t threads) {
+    std::fill(free_cells.begin(), free_cells.end(), 0);
+    std::fill(colliding_cells.begin(), colliding_cells.end(), 0);
+
+    const std::vector<Triangle_2D> &robot_triangles = robot.get_triangles();
+    double robot_radius = robot.get_radius();
+
+    // obstacles at their poses (indexed by the ids of the obstacle grid):
+    std::vector<std::vector<Triangle_2D>> obstacle_triangles;
+    for (const Model_2D *obstacle : obstacles) {
+        obstacle_triangles.push_back(obstacle->get_model());
+    }
+
+    Thread_pool pool(std::max(threads, (size_t)1));
+    std::vector<Obstacle_grid::Query> queries(pool.size());
+    pool.parallel_for(slices, [&](size_t slice, size_t worker) {
+        std::vector<Triangle_2D> triangles; // robot at the pose of the classified cell (reused by all cells)
+        for (int row = 0; row < rows; row++) {
+            for (int column = 0; column < columns; column++) {
+                Cell_state state = classify(column, row, (int)slice, robot_triangles, robot_radius,
+                                            obstacle_triangles, obstacle_grid, queries[worker], triangles);
+                size_t index = bit_index(column, row, (int)slice);
+                if (state == FREE) {
+                    free_cells[index / 64] |= (uint64_t)1 << (index % 64);
+                } else if (state == COLLIDING) {
+                    colliding_cells[index / 64] |= (uint64_t)1 << (index % 64);
+                }
+            }
+        }
+    });
+}
+
+Cspace_grid::Cell_state Cspace_grid::lookup(const double state[]) const {
+    double column = std::floor(state[0] / cell_size);
+    double row = std::floor(state[1] / cell_size);
+    if (!(column >= 0.0 && column < columns && row >= 0.0 && row < rows)) {
+        return UNKNOWN;
+    }
+    double angle = std::fmod(state[2], 2 * M_PI);
+    if (angle < 0.0) {
+        angle += 2 * M_PI;
+    }
+    int slice = std::min((int)(angle / slice_angle), slices - 1);
+
+    size_t index = bit_index((int)column, (int)row, slice);
+    uint64_t mask = (uint64_t)1 << (index % 64);
+    if (free_cells[index / 64] & mask) {
+        return FREE;
+    }
+    if (colliding_cells[index / 64] & mask) {
+        return COLLIDING;
+    }
+    return UNKNOWN;
+}
+
+size_t Cspace_grid::count(Cell_state cell_state) const {
+    size_t free_count = 0, colliding_count = 0;
+    for (uint64_t word : free_cells) {
+        free_count += std::popcount(word);
+    }
+    for (uint64_t word : colliding_cells) {
+        colliding_count += std::popcount(word);
+    }
+    switch (cell_state) {
+    case FREE:
+        return free_count;
+    case COLLIDING:
+        return colliding_count;
+    default:
+        return (size_t)columns * rows * slices - free_count - colliding_count;
+    }
+}
+
+Cspace_grid::Cell_state Cspace_grid::classify(int column, int row, int slice,
+                                              const std::vector<Triangle_2D> &robot_triangles, double robot_radius,
+                                              const std::vector<std::vector<Triangle_2D>> &obstacle_triangles,
+                                              const Obstacle_grid &obstacle_grid, Obstacle_grid::Query &query,
+                                              std::vector<Triangle_2D> &triangles) const {
+    double x = (column + 0.5) * cell_size;
+    double y = (row + 0.5) * cell_size;
+    double angle = (slice + 0.5) * slice_angle;
+    double translation = cell_size * M_SQRT1_2; // max distance of a pose in the cell from the center (in x, y)
+    double rotation = slice_angle / 2;          // max rotation of a pose in the cell from the center
+    double margin = translation + robot_radius * rotation; // max displacement of any robot point inside of the cell
+
+    // robot at the center pose of the cell:
+    double cos_angle = std::cos(angle);
+    double sin_angle = std::sin(angle);
+    triangles.assign(robot_triangles.begin(), robot_triangles.end());
+    Box_2D box = {Point_2D(INFINITY, INFINITY), Point_2D(-INFINITY, -INFINITY)};
+    for (Triangle_2D &triangle : triangles) {
+        for (Point_2D &point : triangle.vertices) {
+            Point_2D local = point;
+            point.set_x(cos_angle * local.get_x() - sin_angle * local.get_y() + x);
+            point.set_y(sin_angle * local.get_x() + cos_angle * local.get_y() + y);
+            box.min = Point_2D(std::min(box.min.get_x(), point.get_x()), std::min(box.min.get_y(), point.get_y()));
+            box.max = Point_2D(std::max(box.max.get_x(), point.get_x()), std::max(box.max.get_y(), point.get_y()));
+        }
+    }
+    box.min = Point_2D(box.min.get_x() - margin, box.min.get_y() - margin);
+    box.max = Point_2D(box.max.get_x() + margin, box.max.get_y() + margin);
+    obstacle_grid.find_overlaps(box, query);
+
+    bool free = true;
+    for (uint32_t id : query.candidates) {
+        for (const Triangle_2D &obstacle : obstacle_triangles[id]) {
+            for (size_t i = 0; i < triangles.size(); i++) {
+                if (triangle_distance(triangles[i], obstacle) > margin + EPSILON) {
+                    continue;
+                }
+                free = false;
+                // the robot collides in the whole cell if it's vertex stays inside of the obstacle:
+                for (int j = 0; j < 3; j++) {
+                    const Point_2D &local = robot_triangles[i].vertices[j];
+                    double vertex_margin = translation + std::hypot(local.get_x(), local.get_y()) * rotation;
+                    if (penetration_depth(triangles[i].vertices[j], obstacle) > vertex_margin + EPSILON) {
+                        return COLLIDING;
+                    }
+                }
+            }
+        }
+    }
+    return free ? FREE : UNKNOWN;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "model_2D.hpp"
+#include "obstacle_grid.hpp"
+
+/**
+ * Precomputed occupancy grid of the (x, y, theta) configuration space of a robot among fixed obstacles.
+ *
+ * Every cell is classified conservatively as certainly free (the robot does not collide at any pose inside of the
+ * cell), certainly colliding (the robot collides at every pose inside of the cell) or unknown (cells on the boundary
+ * of the obstacles - queries in them must be answered by the exact collision check). Both classifications are stored
+ * as bitsets, so a lookup is a constant time operation.
+ *
+ * Poses inside of a cell differ from the pose in it's center by at most the half of the cell diagonal in the
+ * translation and by the half of the slice in the rotation, so every point of the robot in distance r from it's origin
+ * moves by at most translation + r * rotation. The cell is free if all robot triangles at the center pose are further
+ * from the obstacles than that margin and it's colliding if some vertex of the robot lies inside of an obstacle
+ * triangle deeper than it's margin.
+ */
+class Cspace_grid {
+  public:
+    enum Cell_state { FREE, COLLIDING, UNKNOWN };
+
+  private:
+    double cell_size;   // edge length of the cell in the x and y coordinates
+    double slice_angle; // size of the cell in the theta coordinate
+    int columns, rows, slices;
+    size_t slice_words; // number of words of one theta slice (slices don't share words, so they can be built in
+                        // parallel)
+
+    std::vector<uint64_t> free_cells;
+    std::vector<uint64_t> colliding_cells;
+
+  public:
+    /**
+     * @param width width of the world
+     * @param height height of the world
+     * @param cell_size edge length of the cell in the x and y coordinates
+     * @param slices number of cells in the theta coordinate (covering the whole [0, 2 * pi) interval)
+     */
+    Cspace_grid(double width, double height, double cell_size, int slices);
+
+    /**
+     * Classifies all cells of the grid.
+     *
+     * @param robot robot model (it's current pose is ignored)
+     * @param obstacles obstacles at their final poses
+     * @param obstacle_grid broad phase over the obstacles (ids of the obstacles are indices to the obstacles vector)
+     * @param threads number of threads used to classify the theta slices
+     */
+    void build(const Model_2D &robot, const std::vector<Model_2D *> &obstacles, const Obstacle_grid &obstacle_grid,
+               size_t threads);
+
+    /** Returns the state of the cell containing the state (x, y, theta). States outside of the world are UNKNOWN. */
+    Cell_state lookup(const double state[]) const;
+
+    /** Returns the number of cells in the given state. */
+    size_t count(Cell_state cell_state) const;
+
+  private:
+    /** Classifies the cell with the given indices (triangles is a scratch buffer for the robot at the cell pose). */
+    Cell_state classify(int column, int row, int slice, const std::vector<Triangle_2D> &robot_triangles,
+                        double robot_radius, const std::vector<std::vector<Triangle_2D>> &obstacle_triangles,
+                        const Obstacle_grid &obstacle_grid, Obstacle_grid::Query &query,
+                        std::vector<Triangle_2D> &triangles) const;
+    size_t bit_index(int column, int row, int slice) const {
+        return slice * slice_words * 64 + (size_t)row * columns + column;
+    }
+};
@@ -1,11 +1,24 @@
 #include "environment.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 Environment::Environment(const std::string &name, const std::vector<Triangle_2D> &robot_model, double width,
                          double height)
-    : name(name), robot(robot_model, ROBOT_COLOR), width(width), height(height),
+    : name(name), robot(robot_model, ROBOT_COLOR),
+      obstacle_grid(width, height, std::max(width, height) / GRID_CELLS), width(width), height(height),
       renderer(IMAGE_WIDTH, IMAGE_WIDTH * (height / width), width, height),
       solver({{{0.0, width}, {0.0, height}, {0.0, 2 * M_PI}}}, this) {}
 
+Environment::Environment(const Scenario &scenario)
+    : Environment(scenario.name, scenario.robot, scenario.width, scenario.height) {
+    for (const Scenario::Obstacle &obstacle : scenario.obstacles) {
+        add_obstacle(obstacle.model, obstacle.x, obstacle.y, obstacle.angle);
+    }
+    set_start_and_goal_width(scenario.start_goal_width);
+    set_graph_width(scenario.vertex_radius, scenario.line_width);
+}
+
 Environment::~Environment() {
     for (Model_2D *obstacle : obstacles) {
         delete obstacle;
@@ -16,19 +29,17 @@ void Environment::add_obstacle(const std::vector<Triangle_2D> &model, double x,
     Model_2D *new_obstacle = new Model_2D(model, OBSTACLES_COLOR);
     obstacles.push_back(new_obstacle);
     new_obstacle->move(x, y, angle);
+    obstacle_grid.insert(new_obstacle->get_bounding_box());
+    cspace.reset(); // precomputed grid doesn't contain the new obstacle
 }
 
 void Environment::add_rect_obstacle(double width, double height, double x, double y, double angle) {
-    std::vector<Triangle_2D> rect;
-    rect.push_back({Point_2D(-1.0 * width / 2.0, -1.0 * height / 2.0), Point_2D(-1.0 * width / 2.0, height / 2.0),
-                    Point_2D(width / 2.0, height / 2.0)});
-    rect.push_back({Point_2D(-1.0 * width / 2.0, -1.0 * height / 2.0), Point_2D(width / 2.0, -1.0 * height / 2.0),
-                    Point_2D(width / 2.0, height / 2.0)});
-    add_obstacle(rect, x, y, angle);
+    add_obstacle(rect_model(width, height), x, y, angle);
 }
 
 void Environment::run(std::array<double, 3> &start, std::array<double, 3> &goal, int rrt_iters, int rrts_iters,
                       double rrts_step, double delta) {
+    Trace_scope trace("run", "environment");
     robot.move(start[0], start[1], start[2]); // move robot to starting position
     draw_env(start, goal);
     renderer.save_to_png((name + ".png").c_str());
@@ -37,6 +48,7 @@ void Environment::run(std::array<double, 3> &start, std::array<double, 3> &goal,
     std::list<std::array<double, 3>> result_plan_rrt;
     solver.solve_rrt(result_plan_rrt, start, goal, rrt_iters, delta);
     Graph<3> &graph_rrt = solver.get_tree();
+    print_stats("rrt");
 
     draw_tree(graph_rrt);
     renderer.save_to_png((name + "_rrt_tree.png").c_str());
@@ -48,6 +60,25 @@ void Environment::run(std::array<double, 3> &start, std::array<double, 3> &goal,
         create_result_animation(result_plan_rrt, name + "_rrt_anim.gif");
     }
 
+    // test rrt-connect:
+    robot.move(start[0], start[1], start[2]); // move robot to starting position
+    draw_env(start, goal);
+
+    std::list<std::array<double, 3>> result_plan_connect;
+    solver.solve_rrt_connect(result_plan_connect, start, goal, rrt_iters, rrts_step, delta);
+    print_stats("rrt-connect");
+
+    draw_tree(solver.get_tree());
+    draw_tree(solver.get_goal_tree());
+    renderer.save_to_png((name + "_rrt_connect_tree.png").c_str());
+
+    if (!result_plan_connect.empty()) {
+        draw_result(result_plan_connect);
+        renderer.save_to_png((name + "_rrt_connect_result.png").c_str());
+
+        create_result_animation(result_plan_connect, name + "_rrt_connect_anim.gif");
+    }
+
     // test rrt*:
     robot.move(start[0], start[1], start[2]); // move robot to starting position
     draw_env(start, goal);
@@ -55,6 +86,7 @@ void Environment::run(std::array<double, 3> &start, std::array<double, 3> &goal,
     std::list<std::array<double, 3>> result_plan_rrts;
     solver.solve_k_rrts(result_plan_rrts, start, goal, rrts_iters, rrts_step, delta);
     Graph<3> &graph_rrts = solver.get_tree();
+    print_stats("rrt*");
 
     draw_tree(graph_rrts);
     renderer.save_to_png((name + "_rrts_tree.png").c_str());
@@ -67,6 +99,41 @@ void Environment::run(std::array<double, 3> &start, std::array<double, 3> &goal,
     }
 }
 
+void Environment::set_safe_ball_caching(bool enabled) { solver.set_safe_ball_caching(enabled); }
+
+void Environment::set_profiling(bool enabled) { solver.set_profiling(enabled); }
+
+void Environment::print_stats(const std::string &algorithm) const {
+    std::cout << name << " " << algorithm << ": " << solver.get_iterations() << " iterations";
+    const auto &rewires = solver.get_rewire_stats();
+    if (rewires.rewires > 0) {
+        std::cout << ", " << rewires.rewires << " rewires (cascades: " << rewires.cascade_total << " vertices, max "
+                  << rewires.cascade_max << ")";
+    }
+    const auto &balls = solver.get_safe_ball_stats();
+    if (balls.hits + balls.misses > 0) {
+        std::cout << ", safe balls: " << balls.balls << " cached, " << balls.hits << " hits, " << balls.misses
+                  << " misses (" << 100.0 * balls.hits / (balls.hits + balls.misses) << "% hit rate)";
+    }
+    std::cout << std::endl;
+
+    Solve_report report = solver.get_solve_report();
+    if (report.solve.count > 0) {
+        auto print_phase = [](const char *phase, const Solve_report::Phase &stats) {
+            std::cout << ", " << phase << " " << stats.count << " (" << stats.time * 1000 << " ms)";
+        };
+        std::cout << "  profile: " << report.solve.time * 1000 << " ms";
+        print_phase("sampling", report.sampling);
+        std::cout << " with " << report.rejected_samples << " rejected";
+        print_phase("nearest queries", report.nearest_queries);
+        print_phase("collision checks", report.collision_checks);
+        print_phase("edge validations", report.edge_validations);
+        print_phase("rewires", report.rewires);
+        print_phase("insertions", report.insertions);
+        std::cout << std::endl;
+    }
+}
+
 void Environment::draw_result(std::list<std::array<double, 3>> &result_plan) {
     auto &last_state = result_plan.front();
     for (const auto &state : result_plan) {
@@ -80,6 +147,8 @@ void Environment::draw_result(std::list<std::array<double, 3>> &result_plan) {
 void Environment::create_result_animation(std::list<std::array<double, 3>> &result_plan, std::string file_name) {
     auto &start = result_plan.front();
     auto &goal = result_plan.back();
+    Trace_scope trace("gif_encoding", "render");
+    trace.set_arg("frames", result_plan.size());
 
     renderer.start_gif();
     for (auto &state : result_plan) {
@@ -90,10 +159,34 @@ void Environment::create_result_animation(std::list<std::array<double, 3>> &resu
     renderer.save_gif(file_name.c_str());
 }
 
-bool Environment::check_collision(double state[]) {
-    robot.move(state[0], state[1], state[2]);
-    for (Model_2D *obstacle : obstacles) {
-        if (robot.collides_with(*obstacle)) {
+void Environment::precompute_cspace(double cell_size, int slices, size_t threads) {
+    cspace = std::make_unique<Cspace_grid>(width, height, cell_size, slices);
+    cspace->build(robot, obstacles, obstacle_grid, threads);
+    std::clog << name << " cspace: " << cspace->count(Cspace_grid::FREE) << " free, "
+              << cspace->count(Cspace_grid::COLLIDING) << " colliding, " << cspace->count(Cspace_grid::UNKNOWN)
+              << " boundary cells" << std::endl;
+}
+
+bool Environment::check_collision(const double state[], Collision_context &context) const {
+    if (cspace) {
+        switch (cspace->lookup(state)) {
+        case Cspace_grid::FREE:
+            return true;
+        case Cspace_grid::COLLIDING:
+            return false;
+        default:
+            break; // boundary cell -> exact check
+        }
+    }
+    return check_collision_exact(state, static_cast<Environment_context &>(context));
+}
+
+bool Environment::check_collision_exact(const double state[], Environment_context &context) const {
+    Obstacle_grid::Query &query = context.query;
+    // only the obstacles near the robot are passed to the narrow phase:
+    obstacle_grid.find_overlaps(robot.get_bounding_box(state[0], state[1], state[2]), query);
+    for (uint32_t id : query.candidates) {
+        if (robot.collides_with(state[0], state[1], state[2], *obstacles[id])) {
             return false;
         }
     }
@@ -101,6 +194,97 @@ bool Environment::check_collision(double state[]) {
     return true;
 }
 
+void Environment::check_collisions(const double states[], size_t count, size_t stride, bool results[],
+                                   Collision_context &context) const {
+    Obstacle_grid::Query &query = static_cast<Environment_context &>(context).query;
+    double poses[Model_2D::BATCH_SIZE * 3]; // states waiting for the narrow phase
+    size_t indices[Model_2D::BATCH_SIZE];   // their indices in the batch
+    int pending = 0;
+
+    auto check_pending = [&]() {
+        // broad phase over the bounding box of all pending poses:
+        Box_2D box = robot.get_bounding_box(poses[0], poses[1], poses[2]);
+        for (int i = 1; i < pending; i++) {
+            Box_2D pose_box = robot.get_bounding_box(poses[3 * i], poses[3 * i + 1], poses[3 * i + 2]);
+            box.min = Point_2D(std::min(box.min.get_x(), pose_box.min.get_x()),
+                               std::min(box.min.get_y(), pose_box.min.get_y()));
+            box.max = Point_2D(std::max(box.max.get_x(), pose_box.max.get_x()),
+                               std::max(box.max.get_y(), pose_box.max.get_y()));
+        }
+        obstacle_grid.find_overlaps(box, query);
+
+        int all = (1 << pending) - 1;
+        int colliding = 0;
+        for (uint32_t id : query.candidates) {
+            colliding |= robot.collides_with_batch(poses, pending, *obstacles[id]);
+            if (colliding == all) {
+                break;
+            }
+        }
+        for (int i = 0; i < pending; i++) {
+            results[indices[i]] = !(colliding & (1 << i));
+        }
+        pending = 0;
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        const double *state = states + i * stride;
+        if (cspace) {
+            Cspace_grid::Cell_state cell = cspace->lookup(state);
+            if (cell != Cspace_grid::UNKNOWN) {
+                results[i] = cell == Cspace_grid::FREE;
+                continue;
+            }
+        }
+        std::copy(state, state + 3, poses + 3 * pending);
+        indices[pending++] = i;
+        if (pending == Model_2D::BATCH_SIZE) {
+            check_pending();
+        }
+    }
+    if (pending > 0) {
+        check_pending();
+    }
+}
+
+double Environment::get_clearance(const double state[], Collision_context &context, double range, double threshold,
+                                  int &closest) const {
+    Obstacle_grid::Query &query = static_cast<Environment_context &>(context).query;
+    Box_2D box = robot.get_bounding_box(state[0], state[1], state[2]);
+    box.min = Point_2D(box.min.get_x() - range, box.min.get_y() - range);
+    box.max = Point_2D(box.max.get_x() + range, box.max.get_y() + range);
+    obstacle_grid.find_overlaps(box, query);
+
+    double clearance = range;
+    closest = -1;
+    for (uint32_t id : query.candidates) {
+        // current clearance is the range for the next obstacle (further triangles are skipped):
+        double distance = robot.distance_to(state[0], state[1], state[2], *obstacles[id], clearance, threshold);
+        if (distance < clearance) {
+            clearance = distance;
+            closest = (int)id;
+            if (clearance == 0.0 || clearance < threshold) {
+                break;
+            }
+        }
+    }
+    return clearance;
+}
+
+double Environment::get_free_radius(const double state[], Collision_context &context, double min_radius) const {
+    double scale = std::sqrt(1.0 + robot.get_radius() * robot.get_radius()); // clearance needed for a unit radius
+    int closest;
+    double clearance = get_clearance(state, context, std::max(width, height) * FREE_RADIUS_RANGE,
+                                     min_radius * scale, closest);
+    // small margin, so touching states are left to the exact check:
+    double radius = std::max(0.0, clearance - 1e-9) / scale;
+    return radius > min_radius ? radius : 0.0;
+}
+
+std::unique_ptr<Collision_context> Environment::create_context() const {
+    return std::make_unique<Environment_context>();
+}
+
 void Environment::set_start_and_goal_width(double width) { START_GOAL_WIDTH = width; }
 
 void Environment::set_graph_width(double vertex_radius, double line_width) {
@@ -110,25 +294,28 @@ void Environment::set_graph_width(double vertex_radius, double line_width) {
 
 void Environment::set_anim_speed(int centi_seconds) { ANIM_SPEED = centi_seconds; }
 
-void Environment::draw_tree_hlp(const Graph<3>::Vertex *root) {
-    for (const std::pair<Graph<3>::Vertex *, double> &edge : root->edges) {
-        Graph<3>::Vertex *child = edge.first;
+void Environment::draw_tree_hlp(Graph<3>::Vertex root) {
+    for (Graph<3>::Vertex child = root.first_child(); child; child = child.next_sibling()) {
         draw_tree_hlp(child); // recursively drawing subtrees
         // drawing line from root to child:
-        renderer.draw_line(Point_2D(root->coords[0], root->coords[1]), Point_2D(child->coords[0], child->coords[1]),
+        renderer.draw_line(Point_2D(root.coords()[0], root.coords()[1]), Point_2D(child.coords()[0], child.coords()[1]),
                            GRAPH_COLOR, GRAPH_WIDTH);
     }
 }
 
 void Environment::draw_tree(const Graph<3> &graph) {
+    Trace_scope trace("draw_tree", "render");
+    trace.set_arg("vertices", graph.size());
     draw_tree_hlp(graph.get_root()); // drawing edges
     // drawing verticies
-    for (auto vertex : graph.vertices) {
-        renderer.draw_point(Point_2D(vertex->coords[0], vertex->coords[1]), VERTEX_WIDTH, GRAPH_COLOR);
+    for (uint32_t id = 0; id < graph.size(); id++) {
+        auto &coords = graph.get_vertex(id).coords();
+        renderer.draw_point(Point_2D(coords[0], coords[1]), VERTEX_WIDTH, GRAPH_COLOR);
     }
 }
 
 void Environment::draw_env(std::array<double, 3> &start, std::array<double, 3> &goal) {
+    Trace_scope trace("draw_env", "render");
     renderer.fill(BACKGROUND_COLOR);
     renderer.draw_model(robot);
     for (Model_2D *obstacle : obstacles) {
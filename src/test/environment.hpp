@@ -1,14 +1,26 @@
 #pragma once
 
+#include "cspace_grid.hpp"
 #include "model_2D.hpp"
+#include "obstacle_grid.hpp"
 #include "renderer.hpp"
 #include "rrt.hpp"
+#include "scenario.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
+/** Scratch data of the collision queries of one thread. */
+struct Environment_context : Collision_context {
+    Obstacle_grid::Query query; // candidates of the broad phase
+};
+
 class Environment : public Collision_detector {
   private:
     static constexpr int IMAGE_WIDTH = 1920;
+    static constexpr int GRID_CELLS = 32; // number of cells of the obstacle grid along the longer side of the world
+    // obstacles further than this fraction of the longer side of the world are ignored by get_free_radius:
+    static constexpr double FREE_RADIUS_RANGE = 0.25;
     const Color BACKGROUND_COLOR = {255, 255, 255};
     const Color ROBOT_COLOR = {111, 159, 156};
     const Color OBSTACLES_COLOR = {222, 196, 132};
@@ -26,6 +38,8 @@ class Environment : public Collision_detector {
   protected:
     Model_2D robot;
     std::vector<Model_2D *> obstacles;
+    Obstacle_grid obstacle_grid; // broad phase over the obstacles (obstacle ids are indices to the obstacles vector)
+    std::unique_ptr<Cspace_grid> cspace; // precomputed configuration space (nullptr if it's not used)
 
     double width;  // world width
     double height; // world height
@@ -36,15 +50,46 @@ class Environment : public Collision_detector {
 
   public:
     Environment(const std::string &name, const std::vector<Triangle_2D> &robot_model, double width, double height);
+    /** Creates the environment of the scenario (with it's obstacles and visualization parameters). */
+    explicit Environment(const Scenario &scenario);
     ~Environment();
     /** Adds obstacle to the environment on the [x, y] position. */
     void add_obstacle(const std::vector<Triangle_2D> &model, double x, double y, double angle);
     /** Adds rectangular obstacle to the environment. */
     void add_rect_obstacle(double width, double height, double x, double y, double angle);
-    /** Runs tests. */
+    /**
+     * Precomputes the occupancy grid of the configuration space, so most of the collision queries are answered by a
+     * lookup (only the queries in the cells on the boundary of the obstacles use the exact check). Adding an obstacle
+     * discards the grid. Counts of the cells are printed to std::clog.
+     *
+     * @param cell_size edge length of the grid cell in the x and y coordinates
+     * @param slices number of grid cells in the rotation
+     * @param threads number of threads used to build the grid
+     */
+    void precompute_cspace(double cell_size, int slices, size_t threads = 1);
+    /** Enables the safe ball cache of the solver (see RRT_solver::set_safe_ball_caching), it's hit rate is printed by
+     * run. */
+    void set_safe_ball_caching(bool enabled);
+    /** Enables the profiling of the solver (see RRT_solver::set_profiling), the report is printed by run. */
+    void set_profiling(bool enabled);
+    /** Runs tests (rrt, rrt-connect and rrt* - rrt-connect uses rrt_iters and rrts_step). */
     void run(std::array<double, 3> &start, std::array<double, 3> &goal, int rrt_iters, int rrts_iters, double rrts_step,
              double delta);
-    bool check_collision(double state[]) override; // override from Collsion_detector interface
+    // override from Collsion_detector interface:
+    using Collision_detector::check_collision;
+    bool check_collision(const double state[], Collision_context &context) const override;
+    /** Batched check running the separating axis test for Model_2D::BATCH_SIZE states at once (see
+     * Model_2D::collides_with_batch). */
+    using Collision_detector::check_collisions;
+    void check_collisions(const double states[], size_t count, size_t stride, bool results[],
+                          Collision_context &context) const override;
+    /** Returns the distance to the nearest obstacle (closest is set to it's index in the order of adding). */
+    double get_clearance(const double state[], Collision_context &context, double range, double threshold,
+                         int &closest) const override;
+    /** Converts the clearance to the radius of the free ball in the (x, y, angle) space - moving by r in the
+     * configuration space moves any point of the robot by at most r * sqrt(1 + robot_radius^2). */
+    double get_free_radius(const double state[], Collision_context &context, double min_radius) const override;
+    std::unique_ptr<Collision_context> create_context() const override;
 
     /** Customization of visualization parameters */
     void set_start_and_goal_width(double width);
@@ -52,9 +97,13 @@ class Environment : public Collision_detector {
     void set_anim_speed(int centi_seconds);
 
   private:
+    /** Prints the number of iterations (and rewiring, safe ball cache and profiler statistics) of the last solve. */
+    void print_stats(const std::string &algorithm) const;
+    /** Exact collision check (broad phase over the obstacle grid and RAPID narrow phase). */
+    bool check_collision_exact(const double state[], Environment_context &context) const;
     void draw_result(std::list<std::array<double, 3>> &result_plan);
     void create_result_animation(std::list<std::array<double, 3>> &result_plan, std::string file_name);
     void draw_tree(const Graph<3> &graph);
-    void draw_tree_hlp(const Graph<3>::Vertex *root);
+    void draw_tree_hlp(Graph<3>::Vertex root);
     void draw_env(std::array<double, 3> &start, std::array<double, 3> &goal);
 };
@@ -0,0 +1,55 @@
+#include "obstacle_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Obstacle_grid::Obstacle_grid(double width, double height, double cell_size)
+    : cell_size(cell_size), columns(std::max(1, (int)std::ceil(width / cell_size))),
+      rows(std::max(1, (int)std::ceil(height / cell_size))), cells(columns * rows) {}
+
+uint32_t Obstacle_grid::insert(const Box_2D &box) {
+    uint32_t id = (uint32_t)boxes.size();
+    boxes.push_back(box);
+
+    int first_column, last_column, first_row, last_row;
+    cell_range(box.min.get_x(), box.max.get_x(), columns, first_column, last_column);
+    cell_range(box.min.get_y(), box.max.get_y(), rows, first_row, last_row);
+    for (int row = first_row; row <= last_row; row++) {
+        for (int column = first_column; column <= last_column; column++) {
+            cells[row * columns + column].push_back(id);
+        }
+    }
+    return id;
+}
+
+void Obstacle_grid::find_overlaps(const Box_2D &box, Query &query) const {
+    query.candidates.clear();
+    if (query.stamps.size() < boxes.size()) {
+        query.stamps.resize(boxes.size(), query.stamp);
+    }
+    if (++query.stamp == 0) { // stamp overflowed -> resetting the stamps of all obstacles
+        std::fill(query.stamps.begin(), query.stamps.end(), 0);
+        query.stamp = 1;
+    }
+
+    int first_column, last_column, first_row, last_row;
+    cell_range(box.min.get_x(), box.max.get_x(), columns, first_column, last_column);
+    cell_range(box.min.get_y(), box.max.get_y(), rows, first_row, last_row);
+    for (int row = first_row; row <= last_row; row++) {
+        for (int column = first_column; column <= last_column; column++) {
+            for (uint32_t id : cells[row * columns + column]) {
+                if (query.stamps[id] != query.stamp) { // obstacle can be in multiple cells - visiting it only once
+                    query.stamps[id] = query.stamp;
+                    if (boxes[id].overlaps(box)) {
+                        query.candidates.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Obstacle_grid::cell_range(double min, double max, int cells_count, int &first, int &last) const {
+    first = (int)std::clamp(std::floor(min / cell_size), 0.0, (double)(cells_count - 1));
+    last = (int)std::clamp(std::floor(max / cell_size), 0.0, (double)(cells_count - 1));
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graphic_primitives.hpp"
+
+/**
+ * Broad phase of the collision detection - uniform grid over the bounding boxes of the obstacles. Every obstacle is
+ * registered in all cells which it's bounding box overlaps, so a query has to visit only the cells overlapped by the
+ * queried box. Boxes outside of the world are clamped to the border cells.
+ */
+class Obstacle_grid {
+  public:
+    /** Per-thread scratch data of the queries (the grid itself is not modified by them). */
+    struct Query {
+        std::vector<uint32_t> candidates; // result of the last query
+        std::vector<uint32_t> stamps;     // stamp of the last query which visited the obstacle (for deduplication)
+        uint32_t stamp = 0;
+    };
+
+  private:
+    double cell_size;
+    int columns, rows;
+    std::vector<std::vector<uint32_t>> cells; // ids of the obstacles overlapping the cell (row major)
+    std::vector<Box_2D> boxes;                // bounding boxes of the obstacles indexed by their ids
+
+  public:
+    /**
+     * @param width width of the world
+     * @param height height of the world
+     * @param cell_size edge length of the (square) grid cell
+     */
+    Obstacle_grid(double width, double height, double cell_size);
+
+    /** Adds the bounding box of the obstacle to the grid and returns it's id (ids are assigned from zero). */
+    uint32_t insert(const Box_2D &box);
+
+    /**
+     * Finds all obstacles whose bounding boxes overlap the box. Ids of the obstacles are stored to query.candidates
+     * (each of them only once).
+     */
+    void find_overlaps(const Box_2D &box, Query &query) const;
+
+  private:
+    /** Returns the range of cell indices [first, last] covering the interval [min, max] along one axis. */
+    void cell_range(double min, double max, int cells_count, int &first, int &last) const;
+};
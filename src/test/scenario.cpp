@@ -0,0 +1,161 @@
+#include "scenario.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+
+/** Robot made of a square with four smaller squares on it's sides. */
+std::vector<Triangle_2D> cross_robot() {
+    std::vector<Triangle_2D> robot;
+    robot.push_back({Point_2D(-3, 0), Point_2D(3, 0), Point_2D(0, 3)});
+    robot.push_back({Point_2D(-3, 0), Point_2D(-3, 6), Point_2D(0, 3)});
+    robot.push_back({Point_2D(3, 6), Point_2D(3, 0), Point_2D(0, 3)});
+    robot.push_back({Point_2D(-3, 0), Point_2D(3, 0), Point_2D(0, -3)});
+    robot.push_back({Point_2D(-3, 0), Point_2D(0, -3), Point_2D(-3, -6)});
+    robot.push_back({Point_2D(3, 0), Point_2D(3, -6), Point_2D(0, -3)});
+    robot.push_back({Point_2D(-3, 0), Point_2D(-3, 3), Point_2D(-6, 3)});
+    robot.push_back({Point_2D(-3, 0), Point_2D(-3, -3), Point_2D(-6, -3)});
+    robot.push_back({Point_2D(3, 0), Point_2D(3, -3), Point_2D(6, -3)});
+    robot.push_back({Point_2D(3, 0), Point_2D(3, 3), Point_2D(6, 3)});
+    return robot;
+}
+
+/** H shaped robot (24 x 12 for the scale 1). */
+std::vector<Triangle_2D> h_robot(double scale) {
+    std::vector<Triangle_2D> robot;
+    robot.push_back({Point_2D(-6, -1.5), Point_2D(6, -1.5), Point_2D(-6, 1.5)});
+    robot.push_back({Point_2D(6, 1.5), Point_2D(6, -1.5), Point_2D(-6, 1.5)});
+    robot.push_back({Point_2D(-9, -6), Point_2D(-6, -6), Point_2D(-9, 6)});
+    robot.push_back({Point_2D(-6, 6), Point_2D(-6, -6), Point_2D(-9, 6)});
+    robot.push_back({Point_2D(9, 6), Point_2D(6, 6), Point_2D(9, -6)});
+    robot.push_back({Point_2D(6, -6), Point_2D(6, 6), Point_2D(9, -6)});
+    for (Triangle_2D &triangle : robot) {
+        for (Point_2D &point : triangle.vertices) {
+            point = Point_2D(point.get_x() * scale, point.get_y() * scale);
+        }
+    }
+    return robot;
+}
+
+} // namespace
+
+Scenario::Scenario(const std::string &name, const std::vector<Triangle_2D> &robot, double width, double height)
+    : name(name), robot(robot), width(width), height(height) {}
+
+void Scenario::add_obstacle(const std::vector<Triangle_2D> &model, double x, double y, double angle) {
+    obstacles.push_back({model, x, y, angle});
+}
+
+void Scenario::add_rect_obstacle(double width, double height, double x, double y, double angle) {
+    add_obstacle(rect_model(width, height), x, y, angle);
+}
+
+std::vector<Triangle_2D> rect_model(double width, double height) {
+    std::vector<Triangle_2D> rect;
+    rect.push_back({Point_2D(-1.0 * width / 2.0, -1.0 * height / 2.0), Point_2D(-1.0 * width / 2.0, height / 2.0),
+                    Point_2D(width / 2.0, height / 2.0)});
+    rect.push_back({Point_2D(-1.0 * width / 2.0, -1.0 * height / 2.0), Point_2D(width / 2.0, -1.0 * height / 2.0),
+                    Point_2D(width / 2.0, height / 2.0)});
+    return rect;
+}
+
+std::vector<Scenario> test_scenarios() {
+    std::vector<Scenario> scenarios;
+
+    Scenario test0("test0", cross_robot(), 50.0, 50.0);
+    test0.add_rect_obstacle(1.0, 10.0, 25, 25, 0);
+    test0.start = {8.0, 25.0, 0.0};
+    test0.goal = {42.0, 25.0, 0.0};
+    test0.rrt_iters = 500;
+    test0.rrts_iters = 500;
+    test0.rrts_step = 5.0;
+    test0.delta = 1.0;
+    scenarios.push_back(test0);
+
+    Scenario test1("test1", cross_robot(), 50.0, 50.0);
+    test1.add_rect_obstacle(6.0, 5.0, 18, 30, M_PI_2);
+    test1.add_rect_obstacle(10.0, 5.0, 40, 40, 3 * M_PI_4);
+    test1.add_rect_obstacle(30.0, 5.0, 10, 25, 0.0);
+    test1.add_rect_obstacle(30.0, 5.0, 50, 10, 0);
+    test1.start = {8.0, 8.0, 0.0};
+    test1.goal = {10.0, 40.0, 0.0};
+    test1.rrt_iters = 50000;
+    test1.rrts_iters = 10000;
+    test1.rrts_step = 10.0;
+    test1.delta = 1.0;
+    scenarios.push_back(test1);
+
+    Scenario test2("test2", h_robot(1.0), 100.0, 50.0);
+    test2.start_goal_width = 20;
+    test2.vertex_radius = 6;
+    test2.line_width = 6;
+    test2.add_rect_obstacle(3, 20, 30, 52, 0);
+    test2.add_rect_obstacle(3, 30, 30, 12, 0);
+    test2.add_rect_obstacle(3, 20, 60, -2, 0);
+    test2.add_rect_obstacle(3, 32, 60, 40, 0);
+    test2.start = {8.0, 25.0, M_PI_2};
+    test2.goal = {92.0, 25.0, M_PI_2};
+    test2.rrt_iters = 50000;
+    test2.rrts_iters = 10000;
+    test2.rrts_step = 10.0;
+    test2.delta = 1.0;
+    scenarios.push_back(test2);
+
+    Scenario test3("test3", h_robot(0.75), 100.0, 50.0);
+    test3.start_goal_width = 20;
+    test3.vertex_radius = 6;
+    test3.line_width = 6;
+    test3.add_rect_obstacle(100, 1, 50, 50, 0);
+    test3.add_rect_obstacle(100, 1, 50, 0, 0);
+    test3.add_rect_obstacle(1, 50, 0, 25, 0);
+    test3.add_rect_obstacle(1, 50, 100, 25, 0);
+    test3.add_rect_obstacle(3, 22, 32, 25, 0);
+    test3.add_rect_obstacle(3, 16, 25.5, 36, M_PI_2);
+    test3.add_rect_obstacle(3, 16, 25.5, 14, M_PI_2);
+    test3.add_obstacle({{Point_2D(-6.0, 0.0), Point_2D(6.0, 0.0), Point_2D(6.0, 10.0)}}, 60, 30, 0.2);
+    test3.add_obstacle({{Point_2D(-5.0, 0.0), Point_2D(5.0, 0.0), Point_2D(5.0, 9.0)}}, 58, 7, 2.0);
+    test3.add_obstacle({{Point_2D(-7.0, 0.0), Point_2D(7.0, 0.0), Point_2D(0.0, 7.0)}}, 75, 15, 2.0);
+    test3.add_obstacle({{Point_2D(-4.0, 0.0), Point_2D(4.0, 0.0), Point_2D(0.0, 4.0)}}, 80, 40, 0.0);
+    test3.start = {24.0, 25.0, M_PI_2};
+    test3.goal = {92.0, 25.0, M_PI_2};
+    test3.rrt_iters = 50000;
+    test3.rrts_iters = 1000;
+    test3.rrts_step = 10.0;
+    test3.delta = 1.0;
+    scenarios.push_back(test3);
+
+    return scenarios;
+}
+
+Scenario generated_scenario(const std::string &name, double width, double height, int obstacle_count, unsigned seed) {
+    const double robot_scale = 0.75;
+    const double robot_radius = std::hypot(9.0, 6.0) * robot_scale;
+    const double min_size = 2.0, max_size = 12.0; // size range of the obstacle sides
+
+    Scenario scenario(name, h_robot(robot_scale), width, height);
+    scenario.start = {2 * robot_radius, height / 2, M_PI_2};
+    scenario.goal = {width - 2 * robot_radius, height / 2, M_PI_2};
+    scenario.rrt_iters = 50000;
+    scenario.rrts_iters = 5000;
+    scenario.rrts_step = 10.0;
+    scenario.delta = 1.0;
+
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> x_dis(0.0, width);
+    std::uniform_real_distribution<double> y_dis(0.0, height);
+    std::uniform_real_distribution<double> size_dis(min_size, max_size);
+    std::uniform_real_distribution<double> angle_dis(0.0, M_PI);
+    while ((int)scenario.obstacles.size() < obstacle_count) {
+        double x = x_dis(gen), y = y_dis(gen);
+        double obstacle_width = size_dis(gen), obstacle_height = size_dis(gen);
+        double angle = angle_dis(gen);
+        // obstacles must not touch the robot at the start and goal states:
+        double clearance = robot_radius + std::hypot(obstacle_width, obstacle_height) / 2;
+        if (std::hypot(x - scenario.start[0], y - scenario.start[1]) < clearance ||
+            std::hypot(x - scenario.goal[0], y - scenario.goal[1]) < clearance) {
+            continue;
+        }
+        scenario.add_rect_obstacle(obstacle_width, obstacle_height, x, y, angle);
+    }
+    return scenario;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "graphic_primitives.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * Planning problem - the world with the robot and obstacles, start and goal states and the parameters of the solvers.
+ * Used both by the visual tests and by the benchmark.
+ */
+struct Scenario {
+    struct Obstacle {
+        std::vector<Triangle_2D> model;
+        double x, y, angle;
+    };
+
+    std::string name;
+    std::vector<Triangle_2D> robot;
+    double width, height; // size of the world
+    std::vector<Obstacle> obstacles;
+    std::array<double, 3> start, goal;
+
+    int rrt_iters;    // iterations of rrt and rrt-connect
+    int rrts_iters;   // iterations of rrt*
+    double rrts_step; // step of rrt* and rrt-connect
+    double delta;     // collision checking step
+
+    // visualization (see Environment::set_start_and_goal_width and Environment::set_graph_width):
+    double start_goal_width = 30;
+    double vertex_radius = 10;
+    double line_width = 10;
+
+    Scenario(const std::string &name, const std::vector<Triangle_2D> &robot, double width, double height);
+    void add_obstacle(const std::vector<Triangle_2D> &model, double x, double y, double angle);
+    void add_rect_obstacle(double width, double height, double x, double y, double angle);
+};
+
+/** Returns the model of the rectangle with the given size centered in the origin. */
+std::vector<Triangle_2D> rect_model(double width, double height);
+
+/** Returns the hand written test scenarios (test0 - test3). */
+std::vector<Scenario> test_scenarios();
+
+/**
+ * Generates the scenario with randomly placed rectangular obstacles. Start and goal states are on the opposite sides of
+ * the world and obstacles are never placed over them.
+ *
+ * @param name name of the scenario
+ * @param width width of the world
+ * @param height height of the world
+ * @param obstacle_count number of the obstacles
+ * @param seed seed of the generator (the same seed always generates the same scenario)
+ */
+Scenario generated_scenario(const std::string &name, double width, double height, int obstacle_count, unsigned seed);